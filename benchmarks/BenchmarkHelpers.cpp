@@ -0,0 +1,180 @@
+#include "BenchmarkHelpers.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSharedPointer>
+
+#include <cstring>
+
+#include "qgitexception.h"
+
+using namespace LibQGit2;
+
+namespace {
+
+int environmentValue(const char *name, int defaultValue)
+{
+    bool ok = false;
+    int value = qgetenv(name).toInt(&ok);
+    return ok && value >= 0 ? value : defaultValue;
+}
+
+void addPaths(QStringList &paths, const QString &dir, const RepositorySpec &spec, int depth)
+{
+    for (int i = 0; i < spec.treeWidth; ++i) {
+        paths << dir + QString("file%1.txt").arg(i, 4, 10, QChar('0'));
+    }
+    if (depth < spec.treeDepth) {
+        for (int i = 0; i < spec.treeFanout; ++i) {
+            addPaths(paths, dir + QString("dir%1/").arg(i, 2, 10, QChar('0')), spec, depth + 1);
+        }
+    }
+}
+
+void addFile(git_index *index, const QString &path, int version, int size)
+{
+    const QByteArray name = QFile::encodeName(path);
+    const QByteArray content = fileContent(path, version, size);
+
+    git_index_entry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.mode = GIT_FILEMODE_BLOB;
+    entry.path = name.constData();
+    qGitThrow(git_index_add_frombuffer(index, &entry, content.constData(), content.size()));
+}
+
+git_oid writeCommit(git_repository *repo, const git_oid &treeId, const git_oid *parentId, int n)
+{
+    git_signature *signature = 0;
+    qGitThrow(git_signature_new(&signature, "Benchmark", "benchmark@example.com", 1500000000 + n * 60, 0));
+    QSharedPointer<git_signature> signatureGuard(signature, git_signature_free);
+
+    git_tree *tree = 0;
+    qGitThrow(git_tree_lookup(&tree, repo, &treeId));
+    QSharedPointer<git_tree> treeGuard(tree, git_tree_free);
+
+    git_commit *parent = 0;
+    if (parentId) {
+        qGitThrow(git_commit_lookup(&parent, repo, parentId));
+    }
+    QSharedPointer<git_commit> parentGuard(parent, git_commit_free);
+    const git_commit *parents[] = { parent };
+
+    const QByteArray message = QString("Commit %1\n").arg(n).toLatin1();
+    git_oid commit;
+    qGitThrow(git_commit_create(&commit, repo, "HEAD", signature, signature, 0, message.constData(),
+                                tree, parent ? 1 : 0, parents));
+    return commit;
+}
+
+void pack(git_repository *repo, const QString &objectsPath, const QVector<OId> &commits)
+{
+    git_packbuilder *packbuilder = 0;
+    qGitThrow(git_packbuilder_new(&packbuilder, repo));
+    QSharedPointer<git_packbuilder> packbuilderGuard(packbuilder, git_packbuilder_free);
+    for (int n = 0; n < commits.size(); ++n) {
+        qGitThrow(git_packbuilder_insert_commit(packbuilder, commits[n].constData()));
+    }
+    qGitThrow(git_packbuilder_write(packbuilder, 0, 0, 0, 0));
+
+    // drop the loose objects so that every read goes through the pack
+    QDir objects(objectsPath);
+    foreach (const QString &dir, objects.entryList(QStringList("??"), QDir::Dirs | QDir::NoDotAndDotDot)) {
+        QDir(objects.filePath(dir)).removeRecursively();
+    }
+}
+
+}
+
+RepositorySpec RepositorySpec::fromEnvironment(const RepositorySpec &defaults)
+{
+    RepositorySpec spec;
+    spec.commits = qMax(1, environmentValue("BENCH_COMMITS", defaults.commits));
+    spec.treeWidth = qMax(1, environmentValue("BENCH_TREE_WIDTH", defaults.treeWidth));
+    spec.treeDepth = environmentValue("BENCH_TREE_DEPTH", defaults.treeDepth);
+    spec.treeFanout = environmentValue("BENCH_TREE_FANOUT", defaults.treeFanout);
+    spec.blobSize = environmentValue("BENCH_BLOB_SIZE", defaults.blobSize);
+    spec.changesPerCommit = qMax(1, environmentValue("BENCH_CHANGES", defaults.changesPerCommit));
+    return spec;
+}
+
+QStringList RepositorySpec::paths() const
+{
+    QStringList result;
+    addPaths(result, QString(), *this, 0);
+    return result;
+}
+
+QString RepositorySpec::toString() const
+{
+    return QString("%1 commits, %2 files (width %3, depth %4, fanout %5), %6 bytes per blob, %7 changes per commit")
+            .arg(commits).arg(paths().size()).arg(treeWidth).arg(treeDepth).arg(treeFanout)
+            .arg(blobSize).arg(changesPerCommit);
+}
+
+QByteArray fileContent(const QString &path, int version, int size)
+{
+    // only one line differs between two versions, as in a typical change
+    const int lineLength = 64;
+    const int lines = qMax(1, size / lineLength);
+    const QByteArray prefix = path.toUtf8();
+
+    QByteArray content;
+    content.reserve(size + lineLength);
+    for (int line = 0; line < lines; ++line) {
+        QByteArray text = prefix + ' ' + QByteArray::number(line) + ' ' +
+                          QByteArray::number(line == version % lines ? version : 0);
+        text = text.leftJustified(lineLength - 1, '.', true) + '\n';
+        content += text;
+    }
+    return content;
+}
+
+QVector<OId> createRepository(const QString &path, const RepositorySpec &spec, bool bare, bool packed)
+{
+    QDir(path).removeRecursively();
+
+    git_repository *repo = 0;
+    qGitThrow(git_repository_init(&repo, QFile::encodeName(path).constData(), bare));
+    QSharedPointer<git_repository> repoGuard(repo, git_repository_free);
+
+    git_index *index = 0;
+    qGitThrow(git_index_new(&index));
+    QSharedPointer<git_index> indexGuard(index, git_index_free);
+
+    const QStringList paths = spec.paths();
+    QVector<int> versions(paths.size(), 0);
+    for (int i = 0; i < paths.size(); ++i) {
+        addFile(index, paths[i], 0, spec.blobSize);
+    }
+
+    QVector<OId> commits;
+    commits.reserve(spec.commits);
+    int next = 0;
+    for (int n = 0; n < spec.commits; ++n) {
+        if (n > 0) {
+            for (int c = 0; c < spec.changesPerCommit; ++c) {
+                // spread the changes over the whole tree
+                next = (next + 7919) % paths.size();
+                addFile(index, paths[next], ++versions[next], spec.blobSize);
+            }
+        }
+
+        git_oid tree;
+        qGitThrow(git_index_write_tree_to(&tree, index, repo));
+        git_oid commit = writeCommit(repo, tree, n > 0 ? commits.last().constData() : 0, n);
+        commits.append(OId(&commit));
+    }
+
+    if (packed) {
+        pack(repo, QFile::decodeName(git_repository_path(repo)) + "objects", commits);
+    }
+
+    if (!bare) {
+        git_checkout_options opts = GIT_CHECKOUT_OPTIONS_INIT;
+        opts.checkout_strategy = GIT_CHECKOUT_FORCE;
+        qGitThrow(git_checkout_head(repo, &opts));
+    }
+
+    return commits;
+}
@@ -0,0 +1,62 @@
+#ifndef LIBQGIT2_BENCHMARK_HELPERS_H
+#define LIBQGIT2_BENCHMARK_HELPERS_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "qgitoid.h"
+
+#define TO_STR(s) #s
+#define VALUE_TO_QSTR(s) QLatin1String(TO_STR(s))
+
+const QString BenchmarkDir(VALUE_TO_QSTR(BENCHMARK_DIR));
+
+/**
+ * The shape of a synthetic repository.
+ *
+ * Every directory holds treeWidth files and, down to treeDepth levels,
+ * treeFanout subdirectories. The first commit adds all the files; each
+ * following commit changes changesPerCommit of them.
+ */
+struct RepositorySpec
+{
+    int commits;
+    int treeWidth;
+    int treeDepth;
+    int treeFanout;
+    int blobSize;
+    int changesPerCommit;
+
+    /**
+     * Returns \a defaults overridden by the BENCH_COMMITS, BENCH_TREE_WIDTH,
+     * BENCH_TREE_DEPTH, BENCH_TREE_FANOUT, BENCH_BLOB_SIZE and BENCH_CHANGES
+     * environment variables.
+     */
+    static RepositorySpec fromEnvironment(const RepositorySpec &defaults);
+
+    /**
+     * The paths of all the files of the repository.
+     */
+    QStringList paths() const;
+
+    QString toString() const;
+};
+
+/**
+ * Creates a repository at \a path following \a spec.
+ *
+ * A non-bare repository has HEAD checked out. When \a packed is true, all the
+ * objects are moved into a single packfile.
+ *
+ * @return the ids of the commits, oldest first.
+ * @throws LibQGit2::Exception
+ */
+QVector<LibQGit2::OId> createRepository(const QString &path, const RepositorySpec &spec, bool bare, bool packed);
+
+/**
+ * Returns the content of version \a version of the file \a path.
+ */
+QByteArray fileContent(const QString &path, int version, int size);
+
+#endif  // LIBQGIT2_BENCHMARK_HELPERS_H
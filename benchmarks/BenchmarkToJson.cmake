@@ -0,0 +1,44 @@
+# Converts the XML output of QtTest benchmarks to a single JSON document.
+#
+# cmake "-DINPUTS=a.xml;b.xml" -DOUTPUT=benchmarks.json -P BenchmarkToJson.cmake
+#
+# The document holds one entry per benchmark result:
+# { "benchmark": "Lookup", "function": "fullRepository", "tag": "",
+#   "metric": "WalltimeMilliseconds", "value": 0.55, "iterations": 16 }
+
+if(NOT INPUTS OR NOT OUTPUT)
+    message(FATAL_ERROR "INPUTS and OUTPUT must be set")
+endif()
+
+function(xml_attribute element name result)
+    if(element MATCHES " ${name}=\"([^\"]*)\"")
+        set(${result} "${CMAKE_MATCH_1}" PARENT_SCOPE)
+    else()
+        set(${result} "" PARENT_SCOPE)
+    endif()
+endfunction()
+
+set(entries)
+foreach(input ${INPUTS})
+    get_filename_component(benchmark ${input} NAME_WE)
+    file(READ ${input} xml)
+    string(REGEX MATCHALL "<TestFunction name=\"[^\"]*\"|<BenchmarkResult [^>]*>" tokens "${xml}")
+
+    set(function "")
+    foreach(token ${tokens})
+        if(token MATCHES "^<TestFunction name=\"([^\"]*)\"")
+            set(function "${CMAKE_MATCH_1}")
+        else()
+            xml_attribute("${token}" metric metric)
+            xml_attribute("${token}" tag tag)
+            xml_attribute("${token}" value value)
+            xml_attribute("${token}" iterations iterations)
+            string(REPLACE "\"" "\\\"" tag "${tag}")
+            list(APPEND entries "  { \"benchmark\": \"${benchmark}\", \"function\": \"${function}\", \"tag\": \"${tag}\", \"metric\": \"${metric}\", \"value\": ${value}, \"iterations\": ${iterations} }")
+        endif()
+    endforeach()
+endforeach()
+
+string(REPLACE ";" ",\n" body "${entries}")
+file(WRITE ${OUTPUT} "[\n${body}\n]\n")
+message(STATUS "Benchmark results written to ${OUTPUT}")
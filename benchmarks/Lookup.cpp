@@ -0,0 +1,106 @@
+#include "BenchmarkHelpers.h"
+
+#include <QDebug>
+#include <QTest>
+
+#include "qgitexception.h"
+#include "qgitrepository.h"
+
+
+using namespace LibQGit2;
+
+
+/**
+ * Compares the libgit2 prefix lookup, which Repository used for every id, with the
+ * lookups of Repository: direct for full ids, resolved to full ids for short ones.
+ */
+class BenchmarkLookup : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void fullPrefixApi();
+    void fullRepository();
+    void shortPrefixApi();
+    void shortRepository();
+
+private:
+    QVector<OId> shortIds() const;
+
+    Repository repo;
+    QVector<OId> commits;
+};
+
+
+void BenchmarkLookup::initTestCase()
+{
+    try {
+        const RepositorySpec defaults = { 2000, 50, 0, 0, 1024, 1 };
+        const RepositorySpec spec = RepositorySpec::fromEnvironment(defaults);
+        qDebug() << spec.toString();
+
+        const QString path = BenchmarkDir + "/lookup";
+        commits = createRepository(path, spec, true, true);
+        repo.open(path);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+QVector<OId> BenchmarkLookup::shortIds() const
+{
+    // the ids of the first thousand commits, abbreviated as by git log --abbrev=12
+    QVector<OId> ids;
+    foreach (const OId &oid, commits.mid(0, 1000)) {
+        ids.append(OId::stringToOid(oid.format().left(12)));
+    }
+    return ids;
+}
+
+void BenchmarkLookup::fullPrefixApi()
+{
+    QBENCHMARK {
+        foreach (const OId &oid, commits) {
+            git_commit *commit = 0;
+            qGitThrow(git_commit_lookup_prefix(&commit, repo.data(), oid.constData(), oid.length()));
+            git_commit_free(commit);
+        }
+    }
+}
+
+void BenchmarkLookup::fullRepository()
+{
+    QBENCHMARK {
+        foreach (const OId &oid, commits) {
+            repo.lookupCommit(oid);
+        }
+    }
+}
+
+void BenchmarkLookup::shortPrefixApi()
+{
+    const QVector<OId> ids = shortIds();
+    QBENCHMARK {
+        foreach (const OId &oid, ids) {
+            git_commit *commit = 0;
+            qGitThrow(git_commit_lookup_prefix(&commit, repo.data(), oid.constData(), oid.length()));
+            git_commit_free(commit);
+        }
+    }
+}
+
+void BenchmarkLookup::shortRepository()
+{
+    const QVector<OId> ids = shortIds();
+    QBENCHMARK {
+        foreach (const OId &oid, ids) {
+            repo.lookupCommit(oid);
+        }
+    }
+}
+
+QTEST_MAIN(BenchmarkLookup);
+
+#include "Lookup.moc"
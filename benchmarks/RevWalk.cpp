@@ -0,0 +1,105 @@
+#include "BenchmarkHelpers.h"
+
+#include <QDebug>
+#include <QTest>
+
+#include "qgitcommit.h"
+#include "qgitcommitbatch.h"
+#include "qgitexception.h"
+#include "qgitrepository.h"
+#include "qgitrevwalk.h"
+
+
+using namespace LibQGit2;
+
+
+class BenchmarkRevWalk : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void walkOIds_data();
+    void walkOIds();
+    void walkCommits();
+    void walkBatches();
+
+private:
+    Repository repo;
+    int commitCount;
+};
+
+
+void BenchmarkRevWalk::initTestCase()
+{
+    try {
+        const RepositorySpec defaults = { 5000, 20, 1, 2, 256, 1 };
+        const RepositorySpec spec = RepositorySpec::fromEnvironment(defaults);
+        qDebug() << spec.toString();
+
+        const QString path = BenchmarkDir + "/revwalk";
+        commitCount = createRepository(path, spec, true, true).size();
+        repo.open(path);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void BenchmarkRevWalk::walkOIds_data()
+{
+    QTest::addColumn<int>("sorting");
+
+    QTest::newRow("none") << int(RevWalk::None);
+    QTest::newRow("time") << int(RevWalk::Time);
+    QTest::newRow("topological") << int(RevWalk::Topological);
+}
+
+void BenchmarkRevWalk::walkOIds()
+{
+    QFETCH(int, sorting);
+
+    QBENCHMARK {
+        RevWalk rw(repo);
+        rw.setSorting(RevWalk::SortModes(sorting));
+        rw.pushHead();
+        int count = 0;
+        OId oid;
+        while (rw.next(oid)) {
+            ++count;
+        }
+        QCOMPARE(count, commitCount);
+    }
+}
+
+void BenchmarkRevWalk::walkCommits()
+{
+    QBENCHMARK {
+        RevWalk rw(repo);
+        rw.pushHead();
+        int count = 0;
+        Commit commit;
+        while (rw.next(commit)) {
+            ++count;
+        }
+        QCOMPARE(count, commitCount);
+    }
+}
+
+void BenchmarkRevWalk::walkBatches()
+{
+    QBENCHMARK {
+        RevWalk rw(repo);
+        rw.pushHead();
+        int count = 0;
+        CommitBatch batch;
+        while (rw.nextBatch(batch, 1024)) {
+            count += batch.count();
+        }
+        QCOMPARE(count, commitCount);
+    }
+}
+
+QTEST_MAIN(BenchmarkRevWalk);
+
+#include "RevWalk.moc"
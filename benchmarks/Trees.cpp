@@ -0,0 +1,91 @@
+#include "BenchmarkHelpers.h"
+
+#include <QDebug>
+#include <QTest>
+
+#include "qgitcommit.h"
+#include "qgitdiff.h"
+#include "qgitexception.h"
+#include "qgitindex.h"
+#include "qgitrepository.h"
+
+
+using namespace LibQGit2;
+
+
+class BenchmarkTrees : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void diffTrees_data();
+    void diffTrees();
+    void mergeTrees();
+
+private:
+    Tree treeOf(int commit) const;
+
+    Repository repo;
+    QVector<OId> commits;
+};
+
+
+void BenchmarkTrees::initTestCase()
+{
+    try {
+        const RepositorySpec defaults = { 200, 20, 2, 3, 4096, 5 };
+        const RepositorySpec spec = RepositorySpec::fromEnvironment(defaults);
+        qDebug() << spec.toString();
+
+        const QString path = BenchmarkDir + "/trees";
+        commits = createRepository(path, spec, true, true);
+        repo.open(path);
+        QVERIFY2(commits.size() > 1, "the trees benchmarks need at least 2 commits");
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+Tree BenchmarkTrees::treeOf(int commit) const
+{
+    return repo.lookupCommit(commits[commit]).tree();
+}
+
+void BenchmarkTrees::diffTrees_data()
+{
+    QTest::addColumn<int>("distance");
+
+    QTest::newRow("parent") << 1;
+    QTest::newRow("half history") << commits.size() / 2;
+    QTest::newRow("root") << commits.size() - 1;
+}
+
+void BenchmarkTrees::diffTrees()
+{
+    QFETCH(int, distance);
+
+    const Tree newTree = treeOf(commits.size() - 1);
+    const Tree oldTree = treeOf(commits.size() - 1 - distance);
+    QBENCHMARK {
+        Diff diff = repo.diffTrees(oldTree, newTree);
+        QVERIFY(diff.numDeltas() > 0);
+    }
+}
+
+void BenchmarkTrees::mergeTrees()
+{
+    // the changes made since the middle of the history against those of one commit
+    const Tree ancestor = treeOf(commits.size() / 2);
+    const Tree ours = treeOf(commits.size() - 1);
+    const Tree theirs = treeOf(commits.size() / 2 + 1);
+    QBENCHMARK {
+        Index index = repo.mergeTrees(ours, theirs, ancestor);
+        QVERIFY(!index.hasConflicts());
+    }
+}
+
+QTEST_MAIN(BenchmarkTrees);
+
+#include "Trees.moc"
@@ -0,0 +1,136 @@
+#include "BenchmarkHelpers.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QTest>
+
+#include "qgitcheckoutoptions.h"
+#include "qgitcommit.h"
+#include "qgitexception.h"
+#include "qgitindex.h"
+#include "qgitrepository.h"
+#include "qgitstatusoptions.h"
+
+
+using namespace LibQGit2;
+
+
+/**
+ * Operations that touch the working directory: status, adding to the index
+ * and checkout.
+ */
+class BenchmarkWorkdir : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void statusClean();
+    void statusModified();
+    void indexAddByPath();
+    void checkoutTree();
+
+private:
+    void modifyFiles(int count);
+
+    Repository repo;
+    QString path;
+    QStringList files;
+    QVector<OId> commits;
+    RepositorySpec spec;
+};
+
+
+void BenchmarkWorkdir::initTestCase()
+{
+    try {
+        const RepositorySpec defaults = { 50, 20, 2, 3, 4096, 20 };
+        spec = RepositorySpec::fromEnvironment(defaults);
+        qDebug() << spec.toString();
+
+        path = BenchmarkDir + "/workdir";
+        commits = createRepository(path, spec, false, false);
+        files = spec.paths();
+        repo.open(path);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void BenchmarkWorkdir::modifyFiles(int count)
+{
+    for (int i = 0; i < count && i < files.size(); ++i) {
+        QFile file(path + "/" + files[i]);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(fileContent(files[i], 999999, spec.blobSize));
+    }
+}
+
+void BenchmarkWorkdir::statusClean()
+{
+    try {
+        repo.checkoutHead(CheckoutOptions(CheckoutOptions::Force));
+        StatusOptions options(StatusOptions::ShowIndexAndWorkdir, StatusOptions::IncludeUntracked);
+        QBENCHMARK {
+            StatusList status = repo.status(options);
+            QCOMPARE(status.entryCount(), size_t(0));
+        }
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void BenchmarkWorkdir::statusModified()
+{
+    try {
+        repo.checkoutHead(CheckoutOptions(CheckoutOptions::Force));
+        modifyFiles(files.size() / 10 + 1);
+        StatusOptions options(StatusOptions::ShowIndexAndWorkdir, StatusOptions::IncludeUntracked);
+        QBENCHMARK {
+            StatusList status = repo.status(options);
+            QVERIFY(status.entryCount() > 0);
+        }
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void BenchmarkWorkdir::indexAddByPath()
+{
+    try {
+        repo.checkoutHead(CheckoutOptions(CheckoutOptions::Force));
+        const int count = files.size() / 10 + 1;
+        modifyFiles(count);
+        Index index = repo.index();
+        QBENCHMARK {
+            for (int i = 0; i < count && i < files.size(); ++i) {
+                index.addByPath(files[i]);
+            }
+        }
+        index.read(true);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void BenchmarkWorkdir::checkoutTree()
+{
+    try {
+        repo.checkoutHead(CheckoutOptions(CheckoutOptions::Force));
+        const Tree head = repo.lookupCommit(commits.last()).tree();
+        const Tree first = repo.lookupCommit(commits.first()).tree();
+        const CheckoutOptions options(CheckoutOptions::Force);
+        QBENCHMARK {
+            // a round trip, so that every iteration has the same amount of work
+            repo.checkoutTree(first, options);
+            repo.checkoutTree(head, options);
+        }
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+QTEST_MAIN(BenchmarkWorkdir);
+
+#include "Workdir.moc"
@@ -27,10 +27,16 @@
 
 #define LIBQGIT2_SOVERSION 1
 
+#include "qgit2/qgitblame.h"
+#include "qgit2/qgitblamecache.h"
 #include "qgit2/qgitblob.h"
+#include "qgit2/qgitblobreader.h"
+#include "qgit2/qgitblobwriter.h"
 #include "qgit2/qgitcheckoutoptions.h"
 #include "qgit2/qgitcherrypickoptions.h"
 #include "qgit2/qgitcommit.h"
+#include "qgit2/qgitcommitbatch.h"
+#include "qgit2/qgitcommitgraph.h"
 #include "qgit2/qgitconfig.h"
 #include "qgit2/qgitcredentials.h"
 #include "qgit2/qgitdatabase.h"
@@ -38,16 +44,26 @@
 #include "qgit2/qgitdiff.h"
 #include "qgit2/qgitdiffdelta.h"
 #include "qgit2/qgitdifffile.h"
+#include "qgit2/qgitdiffhunk.h"
+#include "qgit2/qgitdiffline.h"
+#include "qgit2/qgitdiffoptions.h"
+#include "qgit2/qgitdiffpatch.h"
+#include "qgit2/qgitdiffstats.h"
 #include "qgit2/qgitexception.h"
 #include "qgit2/qgitglobal.h"
 #include "qgit2/qgitindex.h"
 #include "qgit2/qgitindexentry.h"
 #include "qgit2/qgitindexmodel.h"
+#include "qgit2/qgitindexview.h"
 #include "qgit2/qgitmergeoptions.h"
 #include "qgit2/qgitobject.h"
 #include "qgit2/qgitoid.h"
+#include "qgit2/qgitoidmap.h"
+#include "qgit2/qgitoidset.h"
+#include "qgit2/qgitparallelrevwalk.h"
 #include "qgit2/qgitref.h"
 #include "qgit2/qgitremote.h"
+#include "qgit2/qgitrenameoptions.h"
 #include "qgit2/qgitrepository.h"
 #include "qgit2/qgitrevwalk.h"
 #include "qgit2/qgitsignature.h"
@@ -55,8 +71,11 @@
 #include "qgit2/qgitstatusentry.h"
 #include "qgit2/qgitstatuslist.h"
 #include "qgit2/qgitstatusoptions.h"
+#include "qgit2/qgitstatussnapshot.h"
+#include "qgit2/qgitstatuswatcher.h"
 #include "qgit2/qgittag.h"
 #include "qgit2/qgittree.h"
 #include "qgit2/qgittreeentry.h"
+#include "qgit2/qgittreemodel.h"
 
 #endif
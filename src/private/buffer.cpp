@@ -39,6 +39,11 @@ QString Buffer::asPath() const
     return PathCodec::fromLibGit2(d.ptr);
 }
 
+QByteArray Buffer::asQByteArray() const
+{
+    return QByteArray(d.ptr, int(d.size));
+}
+
 git_buf* Buffer::data()
 {
     return &d;
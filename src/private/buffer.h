@@ -21,6 +21,7 @@
 
 #include "git2.h"
 
+#include <QByteArray>
 #include <QString>
 
 namespace LibQGit2 {
@@ -34,6 +35,9 @@ public:
 
     QString asPath() const;
 
+    /** Copies the content of the buffer. */
+    QByteArray asQByteArray() const;
+
     git_buf* data();
 
 private:
@@ -0,0 +1,73 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "ewah.h"
+
+#include <QtAlgorithms>
+#include <QtEndian>
+
+namespace LibQGit2
+{
+namespace internal
+{
+
+quint32 readEwahBitmap(const uchar *data, quint32 size, quint32 maxBits, QVector<quint32> &positions)
+{
+    positions.clear();
+    if (size < 8) {
+        return 0;
+    }
+    const quint32 bitCount = qFromBigEndian<quint32>(data);
+    const quint32 wordCount = qFromBigEndian<quint32>(data + 4);
+    const quint64 total = 12 + quint64(wordCount) * 8;
+    if (bitCount > maxBits || total > size) {
+        return 0;
+    }
+
+    const uchar *words = data + 8;
+    quint64 bit = 0;
+    quint32 i = 0;
+    while (i < wordCount) {
+        const quint64 marker = qFromBigEndian<quint64>(words + 8 * i++);
+        const quint64 runBits = ((marker >> 1) & Q_UINT64_C(0xffffffff)) * 64;
+        const quint32 literalCount = quint32(marker >> 33);
+
+        if (marker & 1) {
+            for (quint64 b = bit; b < qMin(bit + runBits, quint64(bitCount)); ++b) {
+                positions.append(quint32(b));
+            }
+        }
+        bit += runBits;
+
+        if (literalCount > wordCount - i) {
+            return 0;
+        }
+        for (quint32 k = 0; k < literalCount; ++k, bit += 64) {
+            for (quint64 word = qFromBigEndian<quint64>(words + 8 * i++); word; word &= word - 1) {
+                const quint64 b = bit + qCountTrailingZeroBits(word);
+                if (b < bitCount) {
+                    positions.append(quint32(b));
+                }
+            }
+        }
+    }
+    return quint32(total);
+}
+
+}
+}
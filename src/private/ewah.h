@@ -0,0 +1,50 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_EWAH_H
+#define LIBQGIT2_EWAH_H
+
+#include <QVector>
+
+namespace LibQGit2
+{
+namespace internal
+{
+
+/**
+ * Reads a bitmap in the serialized EWAH format used by git in the index
+ * extensions: the number of bits, the number of 64 bit words, the words and the
+ * position of the last run-length word, all big-endian.
+ *
+ * A run-length word has the value of a run in its lowest bit, the number of
+ * words of the run in the next 32 bits and the number of literal words that
+ * follow it in the upper 31 bits.
+ *
+ * @param data the serialized bitmap
+ * @param size the number of bytes available at \a data
+ * @param maxBits the largest number of bits the caller expects; a bitmap of more
+ * bits is rejected, so that a corrupt one can not expand to billions of positions
+ * @param positions receives the positions of the set bits, in ascending order
+ * @return the number of bytes read, or 0 if the bitmap is corrupt or too large
+ */
+quint32 readEwahBitmap(const uchar *data, quint32 size, quint32 maxBits, QVector<quint32> &positions);
+
+}
+}
+
+#endif // LIBQGIT2_EWAH_H
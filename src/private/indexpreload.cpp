@@ -0,0 +1,161 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "indexpreload.h"
+
+#include <QFile>
+#include <QVector>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+#include "qgitexception.h"
+#include "qgitrepository.h"
+#include "private/workerpool.h"
+
+namespace LibQGit2
+{
+namespace internal
+{
+
+#ifdef Q_OS_UNIX
+
+namespace {
+    const int ChunkSize = 256;
+
+    /** What a worker found out about an entry. */
+    enum Refresh {
+        Unknown,     ///< not looked at, or changed
+        Refreshed    ///< unchanged, with new stat data
+    };
+
+    git_index_time indexTime(const struct timespec &time)
+    {
+        git_index_time result;
+        result.seconds = int32_t(time.tv_sec);
+        result.nanoseconds = uint32_t(time.tv_nsec);
+        return result;
+    }
+
+    bool operator!=(const git_index_time &a, const git_index_time &b)
+    {
+        return a.seconds != b.seconds || a.nanoseconds != b.nanoseconds;
+    }
+
+    bool canRefresh(const git_index_entry *entry)
+    {
+        return GIT_INDEX_ENTRY_STAGE(entry) == 0 &&
+               !(entry->flags_extended & (GIT_INDEX_ENTRY_SKIP_WORKTREE | GIT_INDEX_ENTRY_INTENT_TO_ADD)) &&
+               (entry->mode == GIT_FILEMODE_BLOB || entry->mode == GIT_FILEMODE_BLOB_EXECUTABLE);
+    }
+
+    /** Looks at \a entry, and returns true if it must be refreshed with the stat data put in it. */
+    bool refresh(git_repository *repo, const QByteArray &workDir, git_index_entry &entry)
+    {
+        struct stat st;
+        if (::lstat((workDir + entry.path).constData(), &st) != 0 || !S_ISREG(st.st_mode)) {
+            return false;
+        }
+        if (((st.st_mode & S_IXUSR) != 0) != (entry.mode == GIT_FILEMODE_BLOB_EXECUTABLE) ||
+            entry.file_size != uint32_t(st.st_size)) {
+            return false;   // changed; the status will tell
+        }
+
+#if defined(Q_OS_DARWIN)
+        const git_index_time mtime = indexTime(st.st_mtimespec);
+        const git_index_time ctime = indexTime(st.st_ctimespec);
+#else
+        const git_index_time mtime = indexTime(st.st_mtim);
+        const git_index_time ctime = indexTime(st.st_ctim);
+#endif
+        if (!(entry.mtime != mtime) && !(entry.ctime != ctime) && entry.ino == uint32_t(st.st_ino) &&
+            entry.uid == uint32_t(st.st_uid) && entry.gid == uint32_t(st.st_gid)) {
+            return false;   // unchanged already
+        }
+
+        git_oid oid;
+        qGitThrow(git_repository_hashfile(&oid, repo, entry.path, GIT_OBJ_BLOB, NULL));
+        if (!git_oid_equal(&oid, &entry.id)) {
+            return false;
+        }
+
+        entry.mtime = mtime;
+        entry.ctime = ctime;
+        entry.dev = uint32_t(st.st_dev);
+        entry.ino = uint32_t(st.st_ino);
+        entry.uid = uint32_t(st.st_uid);
+        entry.gid = uint32_t(st.st_gid);
+        return true;
+    }
+}
+
+int preloadIndex(const Repository &repository, git_index *index, int threadCount)
+{
+    const QByteArray workDir = QFile::encodeName(repository.workDirPath());
+    if (workDir.isEmpty()) {
+        return 0;
+    }
+
+    // the workers get copies of the entries, the index itself is only used on this thread
+    const int count = int(git_index_entrycount(index));
+    QVector<git_index_entry> entries;
+    entries.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const git_index_entry *entry = git_index_get_byindex(index, size_t(i));
+        if (canRefresh(entry)) {
+            entries.append(*entry);
+        }
+    }
+    QVector<char> refreshed(entries.size(), Unknown);
+
+    WorkerPool pool(repository.path(), threadCount);
+    git_index_entry *data = entries.data();
+    char *results = refreshed.data();
+    const int size = entries.size();
+    pool.run((size + ChunkSize - 1) / ChunkSize, [data, results, size, &workDir](WorkerPool::Worker &worker, int chunk) {
+        const int end = qMin(size, (chunk + 1) * ChunkSize);
+        for (int i = chunk * ChunkSize; i < end; ++i) {
+            if (refresh(worker.handle.data(), workDir, data[i])) {
+                results[i] = Refreshed;
+            }
+        }
+    });
+
+    // the paths of the copies point into the index, whose entries are updated in place
+    int result = 0;
+    for (int i = 0; i < size; ++i) {
+        if (refreshed[i] == Refreshed) {
+            qGitThrow(git_index_add(index, &entries[i]));
+            ++result;
+        }
+    }
+    return result;
+}
+
+#else
+
+int preloadIndex(const Repository &, git_index *, int)
+{
+    return 0;
+}
+
+#endif
+
+}
+}
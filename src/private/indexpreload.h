@@ -0,0 +1,52 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_INDEXPRELOAD_H
+#define LIBQGIT2_INDEXPRELOAD_H
+
+#include "git2.h"
+
+namespace LibQGit2
+{
+
+class Repository;
+
+namespace internal
+{
+
+/**
+ * Refreshes the stat data of the entries of \a index before a status or a diff
+ * against the working directory, like the core.preloadIndex setting of git.
+ *
+ * The entries are split into chunks that worker threads lstat() one after the
+ * other. The files whose size matches their entry but whose times or inode do
+ * not are hashed by the workers too, and the entries of those that turn out
+ * unchanged get the new stat data. libgit2 then finds them unchanged from their
+ * stat data alone instead of hashing them one by one.
+ *
+ * Only the index in memory is changed. Does nothing on platforms without lstat().
+ *
+ * @return the number of refreshed entries
+ * @throws LibQGit2::Exception
+ */
+int preloadIndex(const Repository &repository, git_index *index, int threadCount);
+
+}
+}
+
+#endif // LIBQGIT2_INDEXPRELOAD_H
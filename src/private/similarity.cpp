@@ -0,0 +1,221 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "similarity.h"
+
+#include <QFile>
+#include <QHash>
+
+#include <algorithm>
+
+namespace {
+
+const size_t MaxTokenSize = 64;
+
+bool isWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+typedef LibQGit2::internal::SimilarityCache::Signature Signature;
+
+int fileSignature(void **out, const git_diff_file *file, const char *fullpath, void *payload)
+{
+    try {
+        Signature signature = static_cast<LibQGit2::internal::SimilarityCache*>(payload)->fromFile(file, fullpath);
+        if (signature.isNull()) {
+            return -1;
+        }
+        *out = new Signature(signature);
+        return 0;
+    } catch (...) {
+        return -1;
+    }
+}
+
+int bufferSignature(void **out, const git_diff_file *file, const char *buf, size_t buflen, void *payload)
+{
+    try {
+        Signature signature = static_cast<LibQGit2::internal::SimilarityCache*>(payload)->fromBuffer(file, buf, buflen);
+        *out = new Signature(signature);
+        return 0;
+    } catch (...) {
+        return -1;
+    }
+}
+
+void freeSignature(void *sig, void *)
+{
+    delete static_cast<Signature*>(sig);
+}
+
+int signatureSimilarity(int *score, void *siga, void *sigb, void *)
+{
+    *score = (*static_cast<Signature*>(siga))->similarity(**static_cast<Signature*>(sigb));
+    return 0;
+}
+
+}
+
+namespace LibQGit2
+{
+namespace internal
+{
+
+SimilaritySignature::SimilaritySignature(const char *data, size_t size, bool ignoreWhitespace)
+{
+    m_hashes.reserve(int(size / 32) + 1);
+
+    char token[MaxTokenSize];
+    size_t length = 0;
+    const char *start = data;
+    const char * const end = data + size;
+    for (const char *p = data; p < end; ++p) {
+        const bool lineEnd = *p == '\n';
+        if (ignoreWhitespace) {
+            if (!isWhitespace(*p)) {
+                token[length++] = *p;
+            }
+            if ((lineEnd || length == MaxTokenSize) && length > 0) {
+                m_hashes.append(qHashBits(token, length));
+                length = 0;
+            }
+        } else if (lineEnd || size_t(p + 1 - start) == MaxTokenSize) {
+            m_hashes.append(qHashBits(start, size_t(p + 1 - start)));
+            start = p + 1;
+        }
+    }
+    if (ignoreWhitespace && length > 0) {
+        m_hashes.append(qHashBits(token, length));
+    } else if (!ignoreWhitespace && start < end) {
+        m_hashes.append(qHashBits(start, size_t(end - start)));
+    }
+
+    std::sort(m_hashes.begin(), m_hashes.end());
+    m_hashes.squeeze();
+}
+
+int SimilaritySignature::similarity(const SimilaritySignature &other) const
+{
+    const int total = m_hashes.size() + other.m_hashes.size();
+    if (total == 0) {
+        return 100;
+    }
+
+    // both lists are sorted, so the common hashes are found by merging them
+    int common = 0;
+    const uint *a = m_hashes.constBegin(), *aEnd = m_hashes.constEnd();
+    const uint *b = other.m_hashes.constBegin(), *bEnd = other.m_hashes.constEnd();
+    while (a != aEnd && b != bEnd) {
+        if (*a < *b) {
+            ++a;
+        } else if (*b < *a) {
+            ++b;
+        } else {
+            ++common;
+            ++a;
+            ++b;
+        }
+    }
+    return 200 * common / total;
+}
+
+int SimilaritySignature::cost() const
+{
+    return int(sizeof(*this)) + m_hashes.size() * int(sizeof(uint));
+}
+
+
+SimilarityCache::SimilarityCache(bool ignoreWhitespace, int maxCost) :
+    m_ignoreWhitespace(ignoreWhitespace),
+    m_signatures(maxCost)
+{
+}
+
+void SimilarityCache::initMetric(git_diff_similarity_metric &metric)
+{
+    metric.file_signature = fileSignature;
+    metric.buffer_signature = bufferSignature;
+    metric.free_signature = freeSignature;
+    metric.similarity = signatureSimilarity;
+    metric.payload = this;
+}
+
+void SimilarityCache::setMaxCost(int maxCost)
+{
+    QMutexLocker lock(&m_mutex);
+    m_signatures.setMaxCost(maxCost);
+}
+
+int SimilarityCache::count() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_signatures.count();
+}
+
+SimilarityCache::Signature SimilarityCache::cached(const git_diff_file *file) const
+{
+    if (!(file->flags & GIT_DIFF_FLAG_VALID_ID) || git_oid_iszero(&file->id)) {
+        return Signature();
+    }
+    QMutexLocker lock(&m_mutex);
+    Signature *signature = m_signatures.object(OId(&file->id));
+    return signature ? *signature : Signature();
+}
+
+void SimilarityCache::insert(const git_diff_file *file, const Signature &signature)
+{
+    if (!(file->flags & GIT_DIFF_FLAG_VALID_ID) || git_oid_iszero(&file->id)) {
+        return;
+    }
+    QMutexLocker lock(&m_mutex);
+    m_signatures.insert(OId(&file->id), new Signature(signature), signature->cost());
+}
+
+SimilarityCache::Signature SimilarityCache::fromBuffer(const git_diff_file *file, const char *data, size_t size)
+{
+    Signature signature = cached(file);
+    if (signature.isNull()) {
+        signature = Signature(new SimilaritySignature(data, size, m_ignoreWhitespace));
+        insert(file, signature);
+    }
+    return signature;
+}
+
+SimilarityCache::Signature SimilarityCache::fromFile(const git_diff_file *file, const char *path)
+{
+    Signature signature = cached(file);
+    if (signature.isNull()) {
+        QFile f(QFile::decodeName(path));
+        if (!f.open(QIODevice::ReadOnly)) {
+            return Signature();
+        }
+        const qint64 size = f.size();
+        if (uchar *data = size > 0 ? f.map(0, size) : 0) {
+            signature = Signature(new SimilaritySignature(reinterpret_cast<const char*>(data), size_t(size), m_ignoreWhitespace));
+        } else {
+            const QByteArray content = f.readAll();
+            signature = Signature(new SimilaritySignature(content.constData(), size_t(content.size()), m_ignoreWhitespace));
+        }
+        insert(file, signature);
+    }
+    return signature;
+}
+
+}
+}
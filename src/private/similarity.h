@@ -0,0 +1,90 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_SIMILARITY_H
+#define LIBQGIT2_SIMILARITY_H
+
+#include <QCache>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "git2.h"
+#include "qgitoid.h"
+
+namespace LibQGit2
+{
+namespace internal
+{
+
+/**
+ * The content signature of a file: the sorted hashes of its lines. Lines longer
+ * than 64 bytes are cut, so files without line breaks are compared by chunks.
+ */
+class SimilaritySignature
+{
+public:
+    SimilaritySignature(const char *data, size_t size, bool ignoreWhitespace);
+
+    /** Returns the similarity with \a other in percent. */
+    int similarity(const SimilaritySignature &other) const;
+
+    /** Returns the approximate memory used by this signature, in bytes. */
+    int cost() const;
+
+private:
+    QVector<uint> m_hashes;
+};
+
+/**
+ * Computes the signatures of the files compared by git_diff_find_similar() and
+ * keeps those of the files with a known id, so that a blob is hashed once even
+ * when it takes part in several diffs. The cache is bounded by the memory used by
+ * the signatures and is safe to use from several threads.
+ */
+class SimilarityCache
+{
+public:
+    SimilarityCache(bool ignoreWhitespace, int maxCost);
+
+    /** Fills \a metric with callbacks using this cache. */
+    void initMetric(git_diff_similarity_metric &metric);
+
+    void setMaxCost(int maxCost);
+
+    /** Returns the number of cached signatures. */
+    int count() const;
+
+    typedef QSharedPointer<const SimilaritySignature> Signature;
+
+    Signature fromBuffer(const git_diff_file *file, const char *data, size_t size);
+    Signature fromFile(const git_diff_file *file, const char *path);
+
+private:
+    Signature cached(const git_diff_file *file) const;
+    void insert(const git_diff_file *file, const Signature &signature);
+
+    const bool m_ignoreWhitespace;
+    mutable QMutex m_mutex;
+    QCache<OId, Signature> m_signatures;
+};
+
+}
+}
+
+#endif // LIBQGIT2_SIMILARITY_H
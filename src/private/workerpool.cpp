@@ -0,0 +1,152 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "workerpool.h"
+
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+
+#include <exception>
+
+#include "private/pathcodec.h"
+
+namespace LibQGit2
+{
+namespace internal
+{
+
+class WorkerPool::Runnable : public QRunnable
+{
+public:
+    Runnable(WorkerPool &pool, Worker &worker) :
+        m_pool(pool),
+        m_worker(worker)
+    {
+    }
+
+    void run()
+    {
+        m_pool.work(m_worker);
+    }
+
+private:
+    WorkerPool &m_pool;
+    Worker &m_worker;
+};
+
+
+WorkerPool::Worker::Worker(git_repository *repo) :
+    handle(repo, git_repository_free),
+    repository(repo)
+{
+}
+
+
+WorkerPool::WorkerPool(const QString &path, int threadCount) :
+    m_count(0),
+    m_next(0),
+    m_failed(0)
+{
+    if (threadCount < 1) {
+        threadCount = QThread::idealThreadCount();
+    }
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+
+    const QByteArray nativePath = PathCodec::toLibGit2(path);
+    for (int i = 0; i < threadCount; ++i) {
+        git_repository *repo = 0;
+        qGitThrow(git_repository_open(&repo, nativePath));
+        m_workers.append(QSharedPointer<Worker>(new Worker(repo)));
+    }
+
+    m_pool.setMaxThreadCount(threadCount);
+}
+
+WorkerPool::~WorkerPool()
+{
+    m_failed.storeRelaxed(1);
+    m_pool.waitForDone();
+}
+
+int WorkerPool::threadCount() const
+{
+    return m_workers.size();
+}
+
+void WorkerPool::start(int count, const Job &job)
+{
+    m_job = job;
+    m_count = count;
+    m_next.storeRelaxed(0);
+    m_failed.storeRelaxed(0);
+    m_error.clear();
+
+    const int runners = qMin(count, m_workers.size());
+    for (int i = 0; i < runners; ++i) {
+        m_pool.start(new Runnable(*this, *m_workers[i]));
+    }
+}
+
+void WorkerPool::wait()
+{
+    m_pool.waitForDone();
+    m_job = Job();
+
+    if (m_error) {
+        Exception error(*m_error);
+        m_error.clear();
+        throw error;
+    }
+}
+
+void WorkerPool::run(int count, const Job &job)
+{
+    start(count, job);
+    wait();
+}
+
+void WorkerPool::work(Worker &worker)
+{
+    int index;
+    while (!m_failed.loadAcquire() && (index = m_next.fetchAndAddRelaxed(1)) < m_count) {
+        try {
+            m_job(worker, index);
+        } catch (const Exception &ex) {
+            fail(ex);
+        } catch (const std::exception &ex) {
+            fail(Exception(QString::fromLocal8Bit(ex.what())));
+        } catch (...) {
+            fail(Exception("WorkerPool: unknown error in a worker thread"));
+        }
+    }
+}
+
+void WorkerPool::fail(const Exception &ex)
+{
+    QMutexLocker lock(&m_errorMutex);
+    if (!m_error) {
+        m_error = QSharedPointer<Exception>(new Exception(ex));
+    }
+    m_failed.storeRelease(1);
+}
+
+}
+}
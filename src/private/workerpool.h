@@ -0,0 +1,117 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_WORKERPOOL_H
+#define LIBQGIT2_WORKERPOOL_H
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+#include <functional>
+
+#include "git2.h"
+#include "qgitexception.h"
+#include "qgitrepository.h"
+
+namespace LibQGit2
+{
+namespace internal
+{
+
+/**
+ * A set of worker threads, each one with its own git_repository handle.
+ *
+ * libgit2 objects must not be shared between threads, so every worker opens the
+ * repository on its own. Jobs are numbered and handed out one at a time from a
+ * shared counter, so a worker that finishes early keeps taking the remaining
+ * jobs instead of waiting for the others.
+ */
+class WorkerPool
+{
+public:
+    class Worker
+    {
+    public:
+        explicit Worker(git_repository *repo);
+
+        /** The handle of this worker; objects looked up through it may keep it alive. */
+        QSharedPointer<git_repository> handle;
+
+        /** A non-owning wrapper around handle. */
+        Repository repository;
+    };
+
+    typedef std::function<void(Worker &worker, int index)> Job;
+
+    /**
+     * Opens \a threadCount handles on the repository at \a path. If \a threadCount
+     * is less than 1 the ideal thread count of the machine is used.
+     *
+     * @throws LibQGit2::Exception
+     */
+    WorkerPool(const QString &path, int threadCount);
+    ~WorkerPool();
+
+    int threadCount() const;
+
+    /**
+     * Starts running \a job for every index in [0, \a count) and returns immediately.
+     */
+    void start(int count, const Job &job);
+
+    /**
+     * Waits until all the jobs given to start() are done.
+     *
+     * @throws LibQGit2::Exception the first error thrown by a job, if any.
+     */
+    void wait();
+
+    /**
+     * Runs \a job for every index in [0, \a count) and waits until all are done.
+     *
+     * @throws LibQGit2::Exception the first error thrown by a job, if any.
+     */
+    void run(int count, const Job &job);
+
+private:
+    class Runnable;
+    friend class Runnable;
+
+    void work(Worker &worker);
+    void fail(const Exception &ex);
+
+    QVector<QSharedPointer<Worker> > m_workers;
+    QThreadPool m_pool;
+
+    Job m_job;
+    int m_count;
+    QAtomicInt m_next;
+    QAtomicInt m_failed;
+
+    QMutex m_errorMutex;
+    QSharedPointer<Exception> m_error;
+};
+
+}
+}
+
+#endif // LIBQGIT2_WORKERPOOL_H
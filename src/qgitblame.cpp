@@ -0,0 +1,104 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitblame.h"
+
+#include <algorithm>
+
+#include "private/pathcodec.h"
+
+namespace LibQGit2
+{
+
+BlameHunk::BlameHunk(const git_blame_hunk *hunk) :
+    m_lines(0),
+    m_finalStart(0),
+    m_origStart(0),
+    m_boundary(false)
+{
+    if (hunk) {
+        m_lines = hunk->lines_in_hunk;
+        m_finalStart = hunk->final_start_line_number;
+        m_origStart = hunk->orig_start_line_number;
+        m_finalCommit = OId(&hunk->final_commit_id);
+        m_origCommit = OId(&hunk->orig_commit_id);
+        m_origPath = PathCodec::fromLibGit2(hunk->orig_path);
+        m_boundary = hunk->boundary != 0;
+    }
+}
+
+
+Blame::Blame(git_blame *blame)
+{
+    if (blame) {
+        QVector<BlameHunk> hunks;
+        const uint32_t count = git_blame_get_hunk_count(blame);
+        hunks.reserve(int(count));
+        for (uint32_t i = 0; i < count; ++i) {
+            hunks.append(BlameHunk(git_blame_get_hunk_byindex(blame, i)));
+        }
+        git_blame_free(blame);
+        d = QSharedPointer<const QVector<BlameHunk> >(new QVector<BlameHunk>(hunks));
+    }
+}
+
+Blame::Blame(const QVector<BlameHunk> &hunks) :
+    d(new QVector<BlameHunk>(hunks))
+{
+}
+
+bool Blame::isNull() const
+{
+    return d.isNull();
+}
+
+size_t Blame::hunkCount() const
+{
+    return d.isNull() ? 0 : size_t(d->size());
+}
+
+BlameHunk Blame::hunk(size_t index) const
+{
+    return d.isNull() ? BlameHunk() : d->value(int(index));
+}
+
+BlameHunk Blame::hunkForLine(size_t line) const
+{
+    if (d.isNull() || line == 0) {
+        return BlameHunk();
+    }
+    // the first hunk starting after the line is just behind the one containing it
+    QVector<BlameHunk>::const_iterator it = std::upper_bound(d->constBegin(), d->constEnd(), line,
+        [](size_t l, const BlameHunk &hunk) { return l < hunk.finalStartLine(); });
+    if (it == d->constBegin()) {
+        return BlameHunk();
+    }
+    --it;
+    return line < it->finalStartLine() + it->lineCount() ? *it : BlameHunk();
+}
+
+size_t Blame::lineCount() const
+{
+    if (d.isNull() || d->isEmpty()) {
+        return 0;
+    }
+    const BlameHunk &last = d->last();
+    return last.finalStartLine() + last.lineCount() - 1;
+}
+
+}
@@ -0,0 +1,148 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_BLAME_H
+#define LIBQGIT2_BLAME_H
+
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "git2.h"
+
+#include "qgitoid.h"
+
+#include "libqgit2_export.h"
+
+namespace LibQGit2
+{
+    /**
+     * @brief A range of consecutive lines of a file last changed by the same commit.
+     *
+     * The hunk holds a copy of its data, so it stays valid after the Blame it was
+     * taken from is gone.
+     *
+     * @ingroup LibQGit2
+     * @{
+     */
+    class LIBQGIT2_EXPORT BlameHunk
+    {
+        public:
+            explicit BlameHunk(const git_blame_hunk *hunk = 0);
+
+            bool isNull() const { return m_lines == 0; }
+
+            /**
+             * The number of lines in the hunk.
+             */
+            size_t lineCount() const { return m_lines; }
+
+            /**
+             * The first line of the hunk in the blamed version of the file, starting at 1.
+             */
+            size_t finalStartLine() const { return m_finalStart; }
+
+            /**
+             * The id of the commit that last changed the lines.
+             */
+            OId finalCommitId() const { return m_finalCommit; }
+
+            /**
+             * The first line of the hunk in the file as of origCommitId(), starting at 1.
+             */
+            size_t origStartLine() const { return m_origStart; }
+
+            /**
+             * The id of the commit the lines were found in.
+             */
+            OId origCommitId() const { return m_origCommit; }
+
+            /**
+             * The path of the file in origCommitId().
+             */
+            QString origPath() const { return m_origPath; }
+
+            /**
+             * True if the lines were not traced further because the oldest commit
+             * of the blame was reached.
+             */
+            bool isBoundary() const { return m_boundary; }
+
+        private:
+            size_t m_lines;
+            size_t m_finalStart;
+            size_t m_origStart;
+            OId m_finalCommit;
+            OId m_origCommit;
+            QString m_origPath;
+            bool m_boundary;
+
+            friend class BlameCache;
+    };
+
+    /**
+     * @brief The commits that last changed each line of a file.
+     *
+     * The hunks are ordered by their line in the blamed version of the file and
+     * cover all its lines.
+     *
+     * @see Repository::blameFile(), BlameCache
+     */
+    class LIBQGIT2_EXPORT Blame
+    {
+        public:
+            /**
+             * Copies the hunks of \a blame and frees it.
+             */
+            explicit Blame(git_blame *blame = 0);
+
+            bool isNull() const;
+
+            /**
+             * Returns the number of hunks.
+             */
+            size_t hunkCount() const;
+
+            /**
+             * Returns the hunk at \a index, or a null hunk if \a index is out of range.
+             */
+            BlameHunk hunk(size_t index) const;
+
+            /**
+             * Returns the hunk containing \a line, starting at 1, or a null hunk if the
+             * file has fewer lines.
+             */
+            BlameHunk hunkForLine(size_t line) const;
+
+            /**
+             * Returns the number of lines of the blamed file.
+             */
+            size_t lineCount() const;
+
+        private:
+            explicit Blame(const QVector<BlameHunk> &hunks);
+
+            QSharedPointer<const QVector<BlameHunk> > d;
+
+            friend class BlameCache;
+    };
+
+    /**@}*/
+}
+
+#endif // LIBQGIT2_BLAME_H
@@ -0,0 +1,202 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitblamecache.h"
+
+#include <QtCore/QCache>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QPair>
+
+#include <algorithm>
+
+#include "qgitexception.h"
+#include "qgitoid.h"
+#include "qgitrepository.h"
+
+namespace LibQGit2
+{
+
+namespace {
+    /** The number of older blames of a path considered as a base for a new one. */
+    const int MaxBasesPerPath = 16;
+
+    typedef QPair<QString, OId> Key;
+}
+
+class BlameCache::Private
+{
+public:
+    Private(const Repository &repository, int maxEntries) :
+        m_repository(&repository),
+        m_blames(maxEntries)
+    {
+    }
+
+    /**
+     * Returns the full id of \a commit, the commit HEAD points to for a null one:
+     * the blames are cached by the commit they are made at, and HEAD moves.
+     */
+    OId resolve(const OId &commit) const
+    {
+        if (!commit.isValid()) {
+            git_oid head;
+            qGitThrow(git_reference_name_to_id(&head, m_repository->data(), "HEAD"));
+            return OId(&head);
+        }
+        if (!commit.isFull()) {
+            return m_repository->lookupCommit(commit).oid();
+        }
+        return commit;
+    }
+
+    const Blame* cached(const QString &path, const OId &commit) const
+    {
+        return m_blames.object(Key(path, commit));
+    }
+
+    /** Finds the most recently blamed commit of \a path that \a commit descends from. */
+    OId findBase(const QString &path, const OId &commit)
+    {
+        QList<OId> &commits = m_commits[path];
+        for (QList<OId>::iterator it = commits.begin(); it != commits.end(); ) {
+            if (!cached(path, *it)) {
+                it = commits.erase(it);
+                continue;
+            }
+            int descends = qGitThrow(git_graph_descendant_of(m_repository->data(), commit.constData(), it->constData()));
+            if (descends) {
+                return *it;
+            }
+            ++it;
+        }
+        return OId();
+    }
+
+    /**
+     * Blames the history from \a base to \a commit only, then replaces the lines
+     * that reached \a base by their attribution in the blame of \a base.
+     * Returns a null blame if the cached blames do not cover all those lines.
+     */
+    Blame update(const QString &path, const OId &commit, const OId &base)
+    {
+        Blame partial = m_repository->blameFile(path, commit, base);
+
+        QVector<BlameHunk> hunks;
+        hunks.reserve(int(partial.hunkCount()));
+        for (size_t i = 0; i < partial.hunkCount(); ++i) {
+            const BlameHunk hunk = partial.hunk(i);
+            if (!hunk.isBoundary() || hunk.finalCommitId() != base) {
+                append(hunks, hunk);
+                continue;
+            }
+
+            const Blame *old = cached(hunk.origPath(), base);
+            if (!old) {
+                return Blame();
+            }
+            const size_t end = hunk.origStartLine() + hunk.lineCount();
+            for (size_t line = hunk.origStartLine(); line < end; ) {
+                BlameHunk piece = old->hunkForLine(line);
+                if (piece.isNull()) {
+                    return Blame();
+                }
+                const size_t offset = line - piece.m_finalStart;
+                piece.m_lines = std::min(piece.m_lines - offset, end - line);
+                piece.m_finalStart = hunk.finalStartLine() + (line - hunk.origStartLine());
+                piece.m_origStart += offset;
+                append(hunks, piece);
+                line += piece.m_lines;
+            }
+        }
+        return Blame(hunks);
+    }
+
+    /** Appends \a hunk, merging it with the last one if it continues it. */
+    static void append(QVector<BlameHunk> &hunks, const BlameHunk &hunk)
+    {
+        if (!hunks.isEmpty()) {
+            BlameHunk &last = hunks.last();
+            if (last.m_finalCommit == hunk.m_finalCommit && last.m_origCommit == hunk.m_origCommit &&
+                last.m_boundary == hunk.m_boundary && last.m_origPath == hunk.m_origPath &&
+                last.m_finalStart + last.m_lines == hunk.m_finalStart &&
+                last.m_origStart + last.m_lines == hunk.m_origStart) {
+                last.m_lines += hunk.m_lines;
+                return;
+            }
+        }
+        hunks.append(hunk);
+    }
+
+    void insert(const QString &path, const OId &commit, const Blame &blame)
+    {
+        m_blames.insert(Key(path, commit), new Blame(blame));
+        QList<OId> &commits = m_commits[path];
+        commits.prepend(commit);
+        if (commits.size() > MaxBasesPerPath) {
+            commits.removeLast();
+        }
+    }
+
+    const Repository *m_repository;
+    QCache<Key, Blame> m_blames;
+    QHash<QString, QList<OId> > m_commits;
+};
+
+
+BlameCache::BlameCache(const Repository& repository, int maxEntries)
+    : d_ptr(new Private(repository, maxEntries))
+{
+}
+
+BlameCache::~BlameCache()
+{
+}
+
+Blame BlameCache::blame(const QString& path, const OId& oid)
+{
+    const OId commit = d_ptr->resolve(oid);
+    if (const Blame *blame = d_ptr->cached(path, commit)) {
+        return *blame;
+    }
+
+    Blame result;
+    const OId base = d_ptr->findBase(path, commit);
+    if (base.isValid()) {
+        result = d_ptr->update(path, commit, base);
+    }
+    if (result.isNull()) {
+        result = d_ptr->m_repository->blameFile(path, commit);
+    }
+
+    d_ptr->insert(path, commit, result);
+    return result;
+}
+
+int BlameCache::count() const
+{
+    return d_ptr->m_blames.count();
+}
+
+void BlameCache::clear()
+{
+    d_ptr->m_blames.clear();
+    d_ptr->m_commits.clear();
+}
+
+}
@@ -0,0 +1,85 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_BLAMECACHE_H
+#define LIBQGIT2_BLAMECACHE_H
+
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+
+#include "qgitblame.h"
+
+#include "libqgit2_export.h"
+
+namespace LibQGit2
+{
+    class OId;
+    class Repository;
+
+    /**
+     * @brief Keeps the blames of files at given commits and updates them incrementally.
+     *
+     * The blames are cached by path and commit. When a file is blamed at a commit
+     * that descends from a commit it was already blamed at, only the history between
+     * the two commits is walked: the lines that did not change since the older commit
+     * keep the attribution found for it. This makes following a moving branch cheap.
+     *
+     * The cache is not thread-safe.
+     *
+     * @ingroup LibQGit2
+     * @{
+     */
+    class LIBQGIT2_EXPORT BlameCache
+    {
+        public:
+            /**
+             * Creates an empty cache for \a repository, holding at most \a maxEntries blames.
+             */
+            explicit BlameCache(const Repository& repository, int maxEntries = 256);
+
+            ~BlameCache();
+
+            /**
+             * Returns the blame of the file at \a path in \a commit. A null \a commit
+             * stands for the commit HEAD points to when this is called.
+             *
+             * @throws LibQGit2::Exception
+             * @see Repository::blameFile()
+             */
+            Blame blame(const QString& path, const OId& commit);
+
+            /**
+             * Returns the number of cached blames.
+             */
+            int count() const;
+
+            /**
+             * Removes all the cached blames.
+             */
+            void clear();
+
+        private:
+            class Private;
+            QSharedPointer<Private> d_ptr;
+            Q_DECLARE_PRIVATE()
+    };
+
+    /**@}*/
+}
+
+#endif // LIBQGIT2_BLAMECACHE_H
@@ -49,6 +49,17 @@ QByteArray Blob::content() const
     return QByteArray::fromRawData( static_cast<const char *>(rawContent()), rawSize() );
 }
 
+BlobContentView Blob::contentView() const
+{
+    BlobContentView view;
+    if (!isNull()) {
+        view.m_blob = *this;
+        view.m_data = static_cast<const char *>(rawContent());
+        view.m_size = qint64(git_blob_rawsize(data()));
+    }
+    return view;
+}
+
 int Blob::rawSize() const
 {
     return git_blob_rawsize(data());
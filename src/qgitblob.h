@@ -21,10 +21,14 @@
 #ifndef LIBQGIT2_BLOB_H
 #define LIBQGIT2_BLOB_H
 
+#include <QtCore/QByteArray>
+
 #include "qgitobject.h"
 
 namespace LibQGit2
 {
+    class BlobContentView;
+
     /**
      * @brief Wrapper class for git_blob.
      *
@@ -67,9 +71,21 @@ namespace LibQGit2
 
             /**
               * @return The blob content as QByteArray.
+              *
+              * The array does not copy the content: it is only valid while this blob
+              * (or a copy of it) exists. Use contentView() to keep the content alive,
+              * or QByteArray::detach() to copy it.
               */
             QByteArray content() const;
 
+            /**
+             * Returns a view on the content of this blob, without copying it.
+             *
+             * The view holds a reference on the blob, so the content stays valid as
+             * long as the view exists.
+             */
+            BlobContentView contentView() const;
+
             /**
              * Get the size in bytes of the contents of a blob
              *
@@ -81,6 +97,43 @@ namespace LibQGit2
             const git_blob* constData() const;
     };
 
+    /**
+     * @brief A read-only view on the content of a Blob.
+     *
+     * The view does not own a copy of the content; it keeps the blob alive
+     * instead, so the content is never copied.
+     */
+    class LIBQGIT2_EXPORT BlobContentView
+    {
+        public:
+            BlobContentView() : m_data(0), m_size(0) {}
+
+            const char* data() const { return m_data; }
+            qint64 size() const { return m_size; }
+            bool isEmpty() const { return m_size == 0; }
+
+            const char* begin() const { return m_data; }
+            const char* end() const { return m_data + m_size; }
+
+            /**
+             * Returns the blob the content belongs to.
+             */
+            Blob blob() const { return m_blob; }
+
+            /**
+             * Returns the content as a QByteArray that does not copy it. The array
+             * is only valid while this view (or a copy of it) exists.
+             */
+            QByteArray toByteArray() const { return QByteArray::fromRawData(m_data, int(m_size)); }
+
+        private:
+            Blob m_blob;
+            const char *m_data;
+            qint64 m_size;
+
+            friend class Blob;
+    };
+
     /**@}*/
 }
 
@@ -0,0 +1,205 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitblobreader.h"
+
+#include <climits>
+#include <cstring>
+
+#include "qgitexception.h"
+#include "qgitrepository.h"
+
+namespace LibQGit2
+{
+
+class BlobReader::Private
+{
+public:
+    Private(const Repository &repository, const OId &oid) :
+        m_repo(repository),
+        m_oid(oid),
+        m_stream(0),
+        m_size(0),
+        m_pos(0),
+        m_maxInflatedSize(0)
+    {
+    }
+
+    ~Private()
+    {
+        close();
+    }
+
+    void open()
+    {
+        close();
+
+        git_odb *odb = 0;
+        qGitThrow(git_repository_odb(&odb, m_repo.data()));
+        m_odb = QSharedPointer<git_odb>(odb, git_odb_free);
+
+        size_t size = 0;
+        git_otype type = GIT_OBJ_BAD;
+        if (git_odb_open_rstream(&m_stream, &size, &type, odb, m_oid.constData()) == GIT_OK) {
+            if (type != GIT_OBJ_BLOB) {
+                close();
+                throw Exception(QString("BlobReader::open(): ") + m_oid.format() + " is not a blob", Exception::Object);
+            }
+            m_size = qint64(size);
+            return;
+        }
+
+        // the backend of the object can not stream it
+        m_stream = 0;
+        if (m_maxInflatedSize > 0) {
+            qGitThrow(git_odb_read_header(&size, &type, odb, m_oid.constData()));
+            if (qint64(size) > m_maxInflatedSize) {
+                close();
+                throw Exception(QString("BlobReader::open(): ") + m_oid.format() + " can not be streamed and is larger than " +
+                                QString::number(m_maxInflatedSize) + " bytes", Exception::Object);
+            }
+        }
+        m_odb.clear();
+        git_blob *blob = 0;
+        qGitThrow(git_blob_lookup(&blob, m_repo.data(), m_oid.constData()));
+        m_blob = QSharedPointer<git_blob>(blob, git_blob_free);
+        m_size = qint64(git_blob_rawsize(blob));
+    }
+
+    void close()
+    {
+        if (m_stream) {
+            git_odb_stream_free(m_stream);
+            m_stream = 0;
+        }
+        m_odb.clear();
+        m_blob.clear();
+        m_size = 0;
+        m_pos = 0;
+    }
+
+    qint64 read(char *data, qint64 maxSize)
+    {
+        maxSize = qMin(maxSize, m_size - m_pos);
+        if (maxSize <= 0) {
+            return 0;
+        }
+
+        if (m_stream) {
+            int read = git_odb_stream_read(m_stream, data, size_t(qMin(maxSize, qint64(INT_MAX))));
+            if (read < 0) {
+                return -1;
+            }
+            m_pos += read;
+            return read;
+        }
+
+        std::memcpy(data, static_cast<const char*>(git_blob_rawcontent(m_blob.data())) + m_pos, size_t(maxSize));
+        m_pos += maxSize;
+        return maxSize;
+    }
+
+    Repository m_repo;
+    OId m_oid;
+    QSharedPointer<git_odb> m_odb;
+    git_odb_stream *m_stream;
+    QSharedPointer<git_blob> m_blob;
+    qint64 m_size;
+    qint64 m_pos;
+    qint64 m_maxInflatedSize;
+};
+
+
+BlobReader::BlobReader(const Repository& repository, const OId& oid, QObject *parent)
+    : QIODevice(parent)
+    , d_ptr(new Private(repository, oid))
+{
+}
+
+BlobReader::~BlobReader()
+{
+}
+
+void BlobReader::setMaxInflatedSize(qint64 size)
+{
+    d_ptr->m_maxInflatedSize = qMax(size, qint64(0));
+}
+
+qint64 BlobReader::maxInflatedSize() const
+{
+    return d_ptr->m_maxInflatedSize;
+}
+
+bool BlobReader::open(OpenMode mode)
+{
+    if ((mode & ReadWrite) != ReadOnly) {
+        setErrorString("BlobReader::open(): a blob can only be opened for reading");
+        return false;
+    }
+
+    try {
+        d_ptr->open();
+    } catch (const Exception &ex) {
+        setErrorString(QString::fromUtf8(ex.message()));
+        return false;
+    }
+
+    return QIODevice::open(mode | Unbuffered);
+}
+
+void BlobReader::close()
+{
+    QIODevice::close();
+    d_ptr->close();
+}
+
+bool BlobReader::isSequential() const
+{
+    return d_ptr->m_stream != 0;
+}
+
+qint64 BlobReader::size() const
+{
+    return d_ptr->m_size;
+}
+
+bool BlobReader::atEnd() const
+{
+    return d_ptr->m_pos >= d_ptr->m_size;
+}
+
+qint64 BlobReader::bytesAvailable() const
+{
+    return d_ptr->m_size - d_ptr->m_pos + QIODevice::bytesAvailable();
+}
+
+qint64 BlobReader::readData(char *data, qint64 maxSize)
+{
+    if (!d_ptr->m_stream && pos() != d_ptr->m_pos) {
+        // seek() only moves the position of QIODevice
+        d_ptr->m_pos = qMin(pos(), d_ptr->m_size);
+    }
+    return d_ptr->read(data, maxSize);
+}
+
+qint64 BlobReader::writeData(const char *, qint64)
+{
+    return -1;
+}
+
+} // namespace LibQGit2
@@ -0,0 +1,105 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_BLOBREADER_H
+#define LIBQGIT2_BLOBREADER_H
+
+#include <QtCore/QIODevice>
+#include <QtCore/QSharedPointer>
+
+#include "qgitoid.h"
+
+#include "libqgit2_export.h"
+
+namespace LibQGit2
+{
+    class Repository;
+
+    /**
+     * @brief A read-only QIODevice over the content of a blob.
+     *
+     * Only loose objects are streamed: their content is read in the chunks
+     * requested by the reader, so reading a blob of any size takes a constant
+     * amount of memory. libgit2 can not stream packed objects, so a packed blob is
+     * inflated whole when the reader is opened, and takes as much memory as its
+     * size; it is then read without being copied again. Set a limit with
+     * setMaxInflatedSize() to refuse to inflate large packed blobs.
+     *
+     * The reader keeps the repository handle alive while it is open.
+     *
+     * @ingroup LibQGit2
+     * @{
+     */
+    class LIBQGIT2_EXPORT BlobReader : public QIODevice
+    {
+        Q_OBJECT
+
+        public:
+            /**
+             * Creates a reader for the blob with the given id. Call open() to read it.
+             */
+            BlobReader(const Repository& repository, const OId& oid, QObject *parent = 0);
+
+            ~BlobReader();
+
+            /**
+             * Sets the size above which a blob that can not be streamed is not
+             * inflated, i.e. open() fails. No limit is set by default, or when \a size
+             * is less than 1.
+             */
+            void setMaxInflatedSize(qint64 size);
+
+            qint64 maxInflatedSize() const;
+
+            /**
+             * Opens the blob; \a mode must be QIODevice::ReadOnly.
+             *
+             * @return false if the blob can not be read or has to be inflated whole
+             * while larger than maxInflatedSize(), see errorString().
+             */
+            bool open(OpenMode mode = ReadOnly);
+
+            void close();
+
+            /**
+             * Returns true when the content is streamed, i.e. can not be seeked.
+             */
+            bool isSequential() const;
+
+            /**
+             * Returns the size of the blob, known as soon as it is open.
+             */
+            qint64 size() const;
+
+            bool atEnd() const;
+            qint64 bytesAvailable() const;
+
+        protected:
+            qint64 readData(char *data, qint64 maxSize);
+            qint64 writeData(const char *data, qint64 maxSize);
+
+        private:
+            class Private;
+            QSharedPointer<Private> d_ptr;
+            Q_DECLARE_PRIVATE()
+    };
+
+    /**@}*/
+}
+
+#endif // LIBQGIT2_BLOBREADER_H
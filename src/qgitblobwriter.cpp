@@ -0,0 +1,142 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitblobwriter.h"
+
+#include "qgitexception.h"
+#include "qgitrepository.h"
+#include "private/pathcodec.h"
+
+namespace LibQGit2
+{
+
+class BlobWriter::Private
+{
+public:
+    Private(const Repository &repository, const QString &hintPath) :
+        m_repo(repository),
+        m_hintPath(hintPath),
+        m_stream(0)
+    {
+    }
+
+    ~Private()
+    {
+        discard();
+    }
+
+    void open()
+    {
+        discard();
+
+        const QByteArray hintPath = PathCodec::toLibGit2(m_hintPath);
+        qGitThrow(git_blob_create_fromstream(&m_stream, m_repo.data(), m_hintPath.isEmpty() ? 0 : hintPath.constData()));
+    }
+
+    void discard()
+    {
+        if (m_stream) {
+            m_stream->free(m_stream);
+            m_stream = 0;
+        }
+    }
+
+    OId commit()
+    {
+        if (!m_stream) {
+            throw Exception("BlobWriter::commit(): the writer is not open");
+        }
+
+        // the stream is freed by libgit2, even on failure
+        git_writestream *stream = m_stream;
+        m_stream = 0;
+        OId oid;
+        qGitThrow(git_blob_create_fromstream_commit(oid.data(), stream));
+        return oid;
+    }
+
+    Repository m_repo;
+    QString m_hintPath;
+    git_writestream *m_stream;
+};
+
+
+BlobWriter::BlobWriter(const Repository& repository, const QString& hintPath, QObject *parent)
+    : QIODevice(parent)
+    , d_ptr(new Private(repository, hintPath))
+{
+}
+
+BlobWriter::~BlobWriter()
+{
+}
+
+bool BlobWriter::open(OpenMode mode)
+{
+    if ((mode & ReadWrite) != WriteOnly) {
+        setErrorString("BlobWriter::open(): a blob can only be opened for writing");
+        return false;
+    }
+
+    try {
+        d_ptr->open();
+    } catch (const Exception &ex) {
+        setErrorString(QString::fromUtf8(ex.message()));
+        return false;
+    }
+
+    return QIODevice::open(mode | Unbuffered);
+}
+
+void BlobWriter::close()
+{
+    QIODevice::close();
+    d_ptr->discard();
+}
+
+bool BlobWriter::isSequential() const
+{
+    return true;
+}
+
+OId BlobWriter::commit()
+{
+    QIODevice::close();
+    return d_ptr->commit();
+}
+
+qint64 BlobWriter::readData(char *, qint64)
+{
+    return -1;
+}
+
+qint64 BlobWriter::writeData(const char *data, qint64 maxSize)
+{
+    if (!d_ptr->m_stream) {
+        return -1;
+    }
+
+    if (d_ptr->m_stream->write(d_ptr->m_stream, data, size_t(maxSize)) < 0) {
+        const git_error *err = giterr_last();
+        setErrorString(err ? QString::fromUtf8(err->message) : QString("BlobWriter: write failed"));
+        return -1;
+    }
+    return maxSize;
+}
+
+} // namespace LibQGit2
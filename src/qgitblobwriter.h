@@ -0,0 +1,95 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_BLOBWRITER_H
+#define LIBQGIT2_BLOBWRITER_H
+
+#include <QtCore/QIODevice>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+
+#include "qgitoid.h"
+
+#include "libqgit2_export.h"
+
+namespace LibQGit2
+{
+    class Repository;
+
+    /**
+     * @brief A write-only QIODevice creating a blob.
+     *
+     * The data written to the device is handed to libgit2 as it comes, which
+     * spools it to a temporary file, so a blob of any size can be created with
+     * a constant amount of memory. The blob only exists once commit() is called;
+     * closing the device before discards the data.
+     *
+     * @ingroup LibQGit2
+     * @{
+     */
+    class LIBQGIT2_EXPORT BlobWriter : public QIODevice
+    {
+        Q_OBJECT
+
+        public:
+            /**
+             * Creates a writer for a new blob in \a repository.
+             *
+             * @param hintPath if not empty, the path of the file the content belongs to,
+             * used to apply the filters configured for it (e.g. line endings).
+             */
+            explicit BlobWriter(const Repository& repository, const QString& hintPath = QString(), QObject *parent = 0);
+
+            ~BlobWriter();
+
+            /**
+             * Starts a new blob; \a mode must be QIODevice::WriteOnly.
+             *
+             * @return false if the blob can not be created, see errorString().
+             */
+            bool open(OpenMode mode = WriteOnly);
+
+            /**
+             * Discards the written data if commit() was not called.
+             */
+            void close();
+
+            bool isSequential() const;
+
+            /**
+             * Writes the blob to the object database and closes the device.
+             *
+             * @return the id of the new blob
+             * @throws LibQGit2::Exception
+             */
+            OId commit();
+
+        protected:
+            qint64 readData(char *data, qint64 maxSize);
+            qint64 writeData(const char *data, qint64 maxSize);
+
+        private:
+            class Private;
+            QSharedPointer<Private> d_ptr;
+            Q_DECLARE_PRIVATE()
+    };
+
+    /**@}*/
+}
+
+#endif // LIBQGIT2_BLOBWRITER_H
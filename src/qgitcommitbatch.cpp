@@ -0,0 +1,220 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitcommitbatch.h"
+#include "qgitoid.h"
+#include "qgitexception.h"
+
+#include <cstring>
+
+namespace LibQGit2
+{
+
+namespace {
+    const char *lineEnd(const char *begin, const char *end)
+    {
+        const char *nl = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        return nl ? nl : end;
+    }
+
+    bool startsWith(const char *begin, const char *end, const char *prefix)
+    {
+        size_t len = std::strlen(prefix);
+        return size_t(end - begin) >= len && std::memcmp(begin, prefix, len) == 0;
+    }
+}
+
+#define THROW(msg) throw Exception(QString("CommitBatch::") + __func__ + "(): " + msg)
+
+CommitBatch::CommitBatch()
+{
+}
+
+int CommitBatch::count() const
+{
+    return m_entries.size();
+}
+
+bool CommitBatch::isEmpty() const
+{
+    return m_entries.isEmpty();
+}
+
+void CommitBatch::clear()
+{
+    // resize() rather than clear() so that the allocated capacity is kept
+    m_entries.resize(0);
+    m_parents.resize(0);
+    m_strings.resize(0);
+}
+
+const CommitBatch::Entry& CommitBatch::at(int i) const
+{
+    return m_entries.at(i);
+}
+
+OId CommitBatch::oid(int i) const
+{
+    return OId(&m_entries.at(i).oid);
+}
+
+int CommitBatch::parentCount(int i) const
+{
+    return m_entries.at(i).parentCount;
+}
+
+OId CommitBatch::parentId(int i, int n) const
+{
+    const Entry &entry = m_entries.at(i);
+    if (n < 0 || n >= entry.parentCount) {
+        return OId();
+    }
+    return OId(&m_parents.at(entry.firstParent + n));
+}
+
+const char* CommitBatch::string(int offset) const
+{
+    return m_strings.constData() + offset;
+}
+
+QString CommitBatch::authorName(int i) const
+{
+    return QString::fromUtf8(string(m_entries.at(i).authorName));
+}
+
+QString CommitBatch::authorEmail(int i) const
+{
+    return QString::fromUtf8(string(m_entries.at(i).authorEmail));
+}
+
+QString CommitBatch::committerName(int i) const
+{
+    return QString::fromUtf8(string(m_entries.at(i).committerName));
+}
+
+QString CommitBatch::committerEmail(int i) const
+{
+    return QString::fromUtf8(string(m_entries.at(i).committerEmail));
+}
+
+const QVector<CommitBatch::Entry>& CommitBatch::entries() const
+{
+    return m_entries;
+}
+
+const QVector<git_oid>& CommitBatch::parents() const
+{
+    return m_parents;
+}
+
+const QByteArray& CommitBatch::stringPool() const
+{
+    return m_strings;
+}
+
+int CommitBatch::appendString(const char *begin, const char *end)
+{
+    int offset = m_strings.size();
+    m_strings.append(begin, int(end - begin));
+    m_strings.append('\0');
+    return offset;
+}
+
+void CommitBatch::parseSignature(const char *begin, const char *end, int &name, int &email, qint64 &time, int &offset)
+{
+    // "Name <email> 1234567890 +0100"
+    const char *lt = static_cast<const char*>(std::memchr(begin, '<', end - begin));
+    const char *gt = lt ? static_cast<const char*>(std::memchr(lt, '>', end - lt)) : 0;
+    if (!gt) {
+        THROW("malformed signature");
+    }
+
+    const char *nameEnd = lt;
+    while (nameEnd > begin && nameEnd[-1] == ' ') {
+        --nameEnd;
+    }
+    name = appendString(begin, nameEnd);
+    email = appendString(lt + 1, gt);
+
+    const char *p = gt + 1;
+    while (p < end && *p == ' ') {
+        ++p;
+    }
+    time = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        time = time * 10 + (*p++ - '0');
+    }
+    while (p < end && *p == ' ') {
+        ++p;
+    }
+
+    offset = 0;
+    if (end - p >= 5 && (*p == '+' || *p == '-')) {
+        int hours = (p[1] - '0') * 10 + (p[2] - '0');
+        int minutes = (p[3] - '0') * 10 + (p[4] - '0');
+        offset = hours * 60 + minutes;
+        if (*p == '-') {
+            offset = -offset;
+        }
+    }
+}
+
+void CommitBatch::append(const git_oid *oid, const char *data, size_t size)
+{
+    Entry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    git_oid_cpy(&entry.oid, oid);
+    entry.firstParent = m_parents.size();
+
+    bool hasAuthor = false;
+    bool hasCommitter = false;
+    const char *end = data + size;
+    const char *line = data;
+    while (line < end && !hasCommitter) {
+        const char *eol = lineEnd(line, end);
+        if (eol == line) {
+            break; // end of the header
+        }
+
+        if (startsWith(line, eol, "parent ")) {
+            git_oid parent;
+            if (eol - line < 7 + GIT_OID_HEXSZ) {
+                THROW("malformed parent");
+            }
+            qGitThrow(git_oid_fromstrn(&parent, line + 7, GIT_OID_HEXSZ));
+            m_parents.append(parent);
+            ++entry.parentCount;
+        } else if (startsWith(line, eol, "author ")) {
+            parseSignature(line + 7, eol, entry.authorName, entry.authorEmail, entry.authorTime, entry.authorTimeOffset);
+            hasAuthor = true;
+        } else if (startsWith(line, eol, "committer ")) {
+            parseSignature(line + 10, eol, entry.committerName, entry.committerEmail, entry.time, entry.timeOffset);
+            hasCommitter = true;
+        }
+
+        line = eol + 1;
+    }
+
+    if (!hasAuthor || !hasCommitter) {
+        THROW("malformed commit");
+    }
+
+    m_entries.append(entry);
+}
+
+} // namespace LibQGit2
@@ -0,0 +1,156 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_COMMITBATCH_H
+#define LIBQGIT2_COMMITBATCH_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "git2.h"
+
+#include "libqgit2_export.h"
+
+namespace LibQGit2
+{
+    class OId;
+
+    /**
+     * @brief A chunk of commit metadata read by RevWalk::nextBatch().
+     *
+     * Instead of wrapping every commit in a Commit object, a CommitBatch stores
+     * one flat Entry per commit. Parent ids are kept in a single shared table and
+     * the author and committer names and emails are kept in a single string pool;
+     * an Entry only holds indices into those.
+     *
+     * A batch can be passed to RevWalk::nextBatch() repeatedly, in which case
+     * its buffers are reused.
+     *
+     * @ingroup LibQGit2
+     * @{
+     */
+    class LIBQGIT2_EXPORT CommitBatch
+    {
+        public:
+            /**
+             * The metadata of a single commit.
+             */
+            struct Entry {
+                git_oid oid;            ///< Id of the commit
+                qint64 time;            ///< Committer time in seconds since epoch
+                int timeOffset;         ///< Committer timezone offset in minutes from UTC
+                qint64 authorTime;      ///< Author time in seconds since epoch
+                int authorTimeOffset;   ///< Author timezone offset in minutes from UTC
+                int firstParent;        ///< Index of the first parent in the parent table
+                int parentCount;        ///< Number of parents
+                int authorName;         ///< Offset of the author name in the string pool
+                int authorEmail;        ///< Offset of the author email in the string pool
+                int committerName;      ///< Offset of the committer name in the string pool
+                int committerEmail;     ///< Offset of the committer email in the string pool
+            };
+
+            /**
+             * Creates an empty batch.
+             */
+            CommitBatch();
+
+            /**
+             * Returns the number of commits in this batch.
+             */
+            int count() const;
+
+            /**
+             * Returns true if this batch holds no commits.
+             */
+            bool isEmpty() const;
+
+            /**
+             * Removes all the commits from this batch, keeping the allocated memory.
+             */
+            void clear();
+
+            /**
+             * Returns the entry of the commit at position \a i.
+             */
+            const Entry& at(int i) const;
+
+            /**
+             * Returns the id of the commit at position \a i.
+             */
+            OId oid(int i) const;
+
+            /**
+             * Returns the number of parents of the commit at position \a i.
+             */
+            int parentCount(int i) const;
+
+            /**
+             * Returns the id of the \a n th parent of the commit at position \a i.
+             */
+            OId parentId(int i, int n) const;
+
+            /**
+             * Returns a NUL-terminated string from the string pool of this batch.
+             *
+             * The pointer is valid as long as the batch is neither changed nor destroyed.
+             *
+             * @param offset an offset stored in an Entry.
+             */
+            const char* string(int offset) const;
+
+            /**
+             * Returns the author name of the commit at position \a i.
+             */
+            QString authorName(int i) const;
+
+            /**
+             * Returns the author email of the commit at position \a i.
+             */
+            QString authorEmail(int i) const;
+
+            /**
+             * Returns the committer name of the commit at position \a i.
+             */
+            QString committerName(int i) const;
+
+            /**
+             * Returns the committer email of the commit at position \a i.
+             */
+            QString committerEmail(int i) const;
+
+            const QVector<Entry>& entries() const;
+            const QVector<git_oid>& parents() const;
+            const QByteArray& stringPool() const;
+
+        private:
+            void append(const git_oid *oid, const char *data, size_t size);
+            int appendString(const char *begin, const char *end);
+            void parseSignature(const char *begin, const char *end, int &name, int &email, qint64 &time, int &offset);
+
+            QVector<Entry> m_entries;
+            QVector<git_oid> m_parents;
+            QByteArray m_strings;
+
+            friend class RevWalk;
+    };
+
+    /**@}*/
+}
+
+#endif // LIBQGIT2_COMMITBATCH_H
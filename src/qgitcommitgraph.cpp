@@ -0,0 +1,675 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitcommitgraph.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+
+#include <algorithm>
+#include <cstring>
+
+#include "qgitoid.h"
+#include "qgitexception.h"
+
+namespace LibQGit2
+{
+
+namespace {
+    /*
+     * File layout, all integers in native byte order:
+     *
+     *   Header
+     *   git_oid  oids[count]            sorted
+     *   (padding to a multiple of 8)
+     *   Record   records[count]         in the order of the oids
+     *   quint32  edges[edgeCount]       parent indices, see Record::firstEdge
+     */
+    const char Magic[4] = { 'Q', 'G', 'C', 'G' };
+    const quint32 Version = 1;
+    const quint32 ByteOrderMark = 0x01020304;
+
+    struct Header {
+        char magic[4];
+        quint32 version;
+        quint32 byteOrder;
+        quint32 count;
+        quint32 edgeCount;
+        quint32 reserved;
+    };
+
+    struct Record {
+        quint32 firstEdge;
+        quint32 parentCount;
+        quint32 generation;
+        quint32 reserved;
+        qint64 time;
+    };
+
+    qint64 recordsOffset(quint32 count)
+    {
+        return (qint64(sizeof(Header)) + qint64(count) * GIT_OID_RAWSZ + 7) & ~qint64(7);
+    }
+
+    qint64 edgesOffset(quint32 count)
+    {
+        return recordsOffset(count) + qint64(count) * sizeof(Record);
+    }
+
+    qint64 fileSize(quint32 count, quint32 edgeCount)
+    {
+        return edgesOffset(count) + qint64(edgeCount) * sizeof(quint32);
+    }
+
+    enum Flag {
+        Parent1 = 1 << 0,
+        Parent2 = 1 << 1,
+        Stale = 1 << 2,
+        Result = 1 << 3,
+        Done = 1 << 4,
+        Queued = 1 << 5
+    };
+
+    /** A commit while the graph is being built. */
+    struct Node {
+        git_oid oid;
+        qint64 time;
+        int firstParent;
+        int parentCount;
+    };
+}
+
+class CommitGraph::Private
+{
+public:
+    explicit Private(const Repository &repository) :
+        m_repo(repository)
+    {
+        detach();
+    }
+
+    void detach()
+    {
+        m_oids = 0;
+        m_records = 0;
+        m_edges = 0;
+        m_count = 0;
+        m_edgeCount = 0;
+    }
+
+    void clear()
+    {
+        detach();
+        m_buffer.clear();
+        if (m_file.isOpen()) {
+            m_file.close();
+        }
+    }
+
+    /** Validates the graph data at \a data and makes the queries use it. */
+    bool attach(const uchar *data, qint64 size)
+    {
+        detach();
+
+        if (size < qint64(sizeof(Header))) {
+            return false;
+        }
+        const Header *header = reinterpret_cast<const Header*>(data);
+        if (std::memcmp(header->magic, Magic, sizeof(Magic)) != 0 ||
+            header->version != Version || header->byteOrder != ByteOrderMark ||
+            size != fileSize(header->count, header->edgeCount)) {
+            return false;
+        }
+
+        const Record *records = reinterpret_cast<const Record*>(data + recordsOffset(header->count));
+        const quint32 *edges = reinterpret_cast<const quint32*>(data + edgesOffset(header->count));
+        for (quint32 i = 0; i < header->count; ++i) {
+            if (quint64(records[i].firstEdge) + records[i].parentCount > header->edgeCount) {
+                return false;
+            }
+        }
+        for (quint32 i = 0; i < header->edgeCount; ++i) {
+            if (edges[i] >= header->count) {
+                return false;
+            }
+        }
+
+        m_oids = reinterpret_cast<const git_oid*>(data + sizeof(Header));
+        m_records = records;
+        m_edges = edges;
+        m_count = header->count;
+        m_edgeCount = header->edgeCount;
+        return true;
+    }
+
+    bool load(const QString &path)
+    {
+        clear();
+
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+
+        const qint64 size = m_file.size();
+        const uchar *data = size > 0 ? m_file.map(0, size) : 0;
+        if (!data || !attach(data, size)) {
+            clear();
+            return false;
+        }
+        return true;
+    }
+
+    int find(const git_oid *oid) const
+    {
+        int lo = 0;
+        int hi = int(m_count);
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            int cmp = git_oid_cmp(&m_oids[mid], oid);
+            if (cmp == 0) {
+                return mid;
+            } else if (cmp < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return -1;
+    }
+
+    void update()
+    {
+        QVector<Node> nodes;
+        QVector<git_oid> parents;
+        collectNewCommits(nodes, parents);
+        if (nodes.isEmpty() && m_count > 0) {
+            return;
+        }
+
+        // the commits already in the graph
+        nodes.reserve(nodes.size() + int(m_count));
+        for (quint32 i = 0; i < m_count; ++i) {
+            Node node;
+            git_oid_cpy(&node.oid, &m_oids[i]);
+            node.time = m_records[i].time;
+            node.firstParent = parents.size();
+            node.parentCount = int(m_records[i].parentCount);
+            for (quint32 p = 0; p < m_records[i].parentCount; ++p) {
+                parents.append(m_oids[m_edges[m_records[i].firstEdge + p]]);
+            }
+            nodes.append(node);
+        }
+
+        std::sort(nodes.begin(), nodes.end(), [](const Node &a, const Node &b) {
+            return git_oid_cmp(&a.oid, &b.oid) < 0;
+        });
+
+        QByteArray buffer = serialize(nodes, parents);
+        clear();
+        m_buffer = buffer;
+        attach(reinterpret_cast<const uchar*>(m_buffer.constData()), m_buffer.size());
+    }
+
+    void collectNewCommits(QVector<Node> &nodes, QVector<git_oid> &parents)
+    {
+        git_repository *repo = m_repo.data();
+
+        git_revwalk *walk = 0;
+        qGitThrow(git_revwalk_new(&walk, repo));
+        QSharedPointer<git_revwalk> walkGuard(walk, git_revwalk_free);
+
+        qGitThrow(git_revwalk_push_glob(walk, "*"));
+        if (qGitThrow(git_repository_head_unborn(repo)) == 0) {
+            qGitThrow(git_revwalk_push_head(walk));
+        }
+
+        // the ancestors of the commits in the graph are in the graph already
+        QVector<bool> hasChild(int(m_count), false);
+        for (quint32 i = 0; i < m_edgeCount; ++i) {
+            hasChild[int(m_edges[i])] = true;
+        }
+        for (quint32 i = 0; i < m_count; ++i) {
+            if (!hasChild[int(i)]) {
+                qGitThrow(git_revwalk_hide(walk, &m_oids[i]));
+            }
+        }
+
+        git_oid oid;
+        int err;
+        while ((err = git_revwalk_next(&oid, walk)) == GIT_OK) {
+            git_commit *commit = 0;
+            qGitThrow(git_commit_lookup(&commit, repo, &oid));
+
+            Node node;
+            git_oid_cpy(&node.oid, &oid);
+            node.time = git_commit_time(commit);
+            node.firstParent = parents.size();
+            node.parentCount = int(git_commit_parentcount(commit));
+            for (int p = 0; p < node.parentCount; ++p) {
+                parents.append(*git_commit_parent_id(commit, p));
+            }
+            nodes.append(node);
+
+            git_commit_free(commit);
+        }
+        if (err != GIT_ITEROVER) {
+            qGitThrow(err);
+        }
+    }
+
+    static QByteArray serialize(const QVector<Node> &nodes, const QVector<git_oid> &parents)
+    {
+        const quint32 count = quint32(nodes.size());
+
+        // resolve the parents to indices; parents missing from the repository
+        // (e.g. in shallow clones) are left out
+        QVector<quint32> edges;
+        edges.reserve(parents.size());
+        QVector<Record> records(int(count));
+        for (int i = 0; i < nodes.size(); ++i) {
+            Record &record = records[i];
+            std::memset(&record, 0, sizeof(record));
+            record.firstEdge = quint32(edges.size());
+            record.time = nodes[i].time;
+            for (int p = 0; p < nodes[i].parentCount; ++p) {
+                const git_oid *parent = &parents[nodes[i].firstParent + p];
+                QVector<Node>::const_iterator it = std::lower_bound(nodes.constBegin(), nodes.constEnd(), parent,
+                    [](const Node &node, const git_oid *oid) {
+                        return git_oid_cmp(&node.oid, oid) < 0;
+                    });
+                if (it != nodes.constEnd() && git_oid_equal(&it->oid, parent)) {
+                    edges.append(quint32(it - nodes.constBegin()));
+                    ++record.parentCount;
+                }
+            }
+        }
+
+        computeGenerations(records, edges);
+
+        const quint32 edgeCount = quint32(edges.size());
+        QByteArray buffer(int(fileSize(count, edgeCount)), '\0');
+        char *data = buffer.data();
+
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.byteOrder = ByteOrderMark;
+        header.count = count;
+        header.edgeCount = edgeCount;
+        std::memcpy(data, &header, sizeof(header));
+
+        git_oid *oids = reinterpret_cast<git_oid*>(data + sizeof(Header));
+        for (int i = 0; i < nodes.size(); ++i) {
+            git_oid_cpy(&oids[i], &nodes[i].oid);
+        }
+        std::memcpy(data + recordsOffset(count), records.constData(), count * sizeof(Record));
+        std::memcpy(data + edgesOffset(count), edges.constData(), edgeCount * sizeof(quint32));
+
+        return buffer;
+    }
+
+    static void computeGenerations(QVector<Record> &records, const QVector<quint32> &edges)
+    {
+        QVector<quint32> stack;
+        for (int i = 0; i < records.size(); ++i) {
+            if (records[i].generation != 0) {
+                continue;
+            }
+
+            stack.append(quint32(i));
+            while (!stack.isEmpty()) {
+                Record &record = records[int(stack.last())];
+                if (record.generation != 0) {
+                    stack.removeLast();
+                    continue;
+                }
+
+                bool ready = true;
+                quint32 generation = 0;
+                for (quint32 p = 0; p < record.parentCount; ++p) {
+                    quint32 parent = edges[int(record.firstEdge + p)];
+                    quint32 parentGeneration = records[int(parent)].generation;
+                    if (parentGeneration == 0) {
+                        stack.append(parent);
+                        ready = false;
+                    } else {
+                        generation = qMax(generation, parentGeneration);
+                    }
+                }
+
+                if (ready) {
+                    records[int(stack.last())].generation = generation + 1;
+                    stack.removeLast();
+                }
+            }
+        }
+    }
+
+    /** Orders a heap so that the commit with the highest generation is on top. */
+    bool lowerGeneration(quint32 a, quint32 b) const
+    {
+        if (m_records[a].generation != m_records[b].generation) {
+            return m_records[a].generation < m_records[b].generation;
+        }
+        return m_records[a].time < m_records[b].time;
+    }
+
+    /**
+     * A queue of commits by decreasing generation, which paints the commits with
+     * flags. A commit is queued at most once at a time, and the queue counts the
+     * queued commits that do not have all the flags of the stop mask, so that
+     * walks end as soon as only such commits are left.
+     */
+    class Queue
+    {
+    public:
+        Queue(const Private &graph, QHash<quint32, int> &flags, int stopMask) :
+            m_graph(graph),
+            m_flags(flags),
+            m_stopMask(stopMask),
+            m_active(0)
+        {
+        }
+
+        /** Adds \a paint to the flags of \a commit, and queues it if needed. */
+        void paint(quint32 commit, int paint)
+        {
+            int &flags = m_flags[commit];
+            const bool wasActive = (flags & Queued) && !stopped(flags);
+            flags |= paint;
+            if (!(flags & Queued)) {
+                flags |= Queued;
+                m_heap.push_back(commit);
+                std::push_heap(m_heap.begin(), m_heap.end(), compare());
+                if (!stopped(flags)) {
+                    ++m_active;
+                }
+            } else if (wasActive && stopped(flags)) {
+                --m_active;
+            }
+        }
+
+        quint32 pop()
+        {
+            std::pop_heap(m_heap.begin(), m_heap.end(), compare());
+            quint32 commit = m_heap.back();
+            m_heap.pop_back();
+
+            int &flags = m_flags[commit];
+            flags &= ~Queued;
+            if (!stopped(flags)) {
+                --m_active;
+            }
+            return commit;
+        }
+
+        /** Returns true if a queued commit does not have all the flags of the stop mask. */
+        bool hasActive() const
+        {
+            return m_active > 0;
+        }
+
+    private:
+        struct Compare {
+            const Private *graph;
+            bool operator()(quint32 a, quint32 b) const { return graph->lowerGeneration(a, b); }
+        };
+
+        Compare compare() const
+        {
+            Compare c = { &m_graph };
+            return c;
+        }
+
+        bool stopped(int flags) const
+        {
+            return (flags & m_stopMask) == m_stopMask;
+        }
+
+        const Private &m_graph;
+        QHash<quint32, int> &m_flags;
+        const int m_stopMask;
+        int m_active;
+        std::vector<quint32> m_heap;
+    };
+
+    bool isAncestor(quint32 ancestor, quint32 descendant) const
+    {
+        if (ancestor == descendant) {
+            return true;
+        }
+
+        const quint32 generation = m_records[ancestor].generation;
+        if (m_records[descendant].generation <= generation) {
+            return false;
+        }
+
+        QSet<quint32> seen;
+        QVector<quint32> stack;
+        stack.append(descendant);
+        seen.insert(descendant);
+        while (!stack.isEmpty()) {
+            const Record &record = m_records[stack.takeLast()];
+            for (quint32 p = 0; p < record.parentCount; ++p) {
+                quint32 parent = m_edges[record.firstEdge + p];
+                if (parent == ancestor) {
+                    return true;
+                }
+                // the ancestors of a commit all have a lower generation
+                if (m_records[parent].generation <= generation || seen.contains(parent)) {
+                    continue;
+                }
+                seen.insert(parent);
+                stack.append(parent);
+            }
+        }
+        return false;
+    }
+
+    int mergeBase(quint32 one, quint32 two) const
+    {
+        if (one == two) {
+            return int(one);
+        }
+
+        // the flags of the visited commits only, as a walk usually visits a few
+        QHash<quint32, int> flags;
+        Queue queue(*this, flags, Stale);
+        queue.paint(one, Parent1);
+        queue.paint(two, Parent2);
+
+        // the commits reachable from a common commit are stale: they are common too,
+        // but can not be better merge bases
+        int result = -1;
+        while (queue.hasActive()) {
+            quint32 commit = queue.pop();
+            int paint = flags.value(commit) & (Parent1 | Parent2 | Stale);
+            if (paint == (Parent1 | Parent2)) {
+                // commits come out of the queue by decreasing generation, so the
+                // first common one can not be an ancestor of another common one
+                if (result < 0) {
+                    result = int(commit);
+                }
+                paint |= Stale;
+            }
+
+            const Record &record = m_records[commit];
+            for (quint32 p = 0; p < record.parentCount; ++p) {
+                quint32 parent = m_edges[record.firstEdge + p];
+                if ((flags.value(parent) & paint) != paint) {
+                    queue.paint(parent, paint);
+                }
+            }
+        }
+        return result;
+    }
+
+    Repository::GraphRelationship aheadBehind(quint32 local, quint32 upstream) const
+    {
+        Repository::GraphRelationship result = { 0, 0 };
+        if (local == upstream) {
+            return result;
+        }
+
+        // once only commits reachable from both sides are left they can not change the counts
+        QHash<quint32, int> flags;
+        Queue queue(*this, flags, Parent1 | Parent2);
+        queue.paint(local, Parent1);
+        queue.paint(upstream, Parent2);
+
+        while (queue.hasActive()) {
+            quint32 commit = queue.pop();
+            int &commitFlags = flags[commit];
+            if (commitFlags & Done) {
+                continue;
+            }
+            commitFlags |= Done;
+
+            int paint = commitFlags & (Parent1 | Parent2);
+            if (paint == Parent1) {
+                ++result.ahead;
+            } else if (paint == Parent2) {
+                ++result.behind;
+            }
+
+            const Record &record = m_records[commit];
+            for (quint32 p = 0; p < record.parentCount; ++p) {
+                quint32 parent = m_edges[record.firstEdge + p];
+                if ((flags.value(parent) & paint) != paint) {
+                    queue.paint(parent, paint);
+                }
+            }
+        }
+        return result;
+    }
+
+    Repository m_repo;
+    QFile m_file;
+    QByteArray m_buffer;
+
+    const git_oid *m_oids;
+    const Record *m_records;
+    const quint32 *m_edges;
+    quint32 m_count;
+    quint32 m_edgeCount;
+};
+
+
+CommitGraph::CommitGraph(const Repository& repository)
+    : d_ptr(new Private(repository))
+{
+}
+
+CommitGraph::~CommitGraph()
+{
+}
+
+QString CommitGraph::defaultPath(const Repository& repository)
+{
+    return repository.path() + "libqgit2-commit-graph";
+}
+
+bool CommitGraph::load()
+{
+    return d_ptr->load(defaultPath(d_ptr->m_repo));
+}
+
+void CommitGraph::update()
+{
+    d_ptr->update();
+    write(defaultPath(d_ptr->m_repo));
+}
+
+void CommitGraph::write(const QString& path) const
+{
+    const qint64 size = fileSize(d_ptr->m_count, d_ptr->m_edgeCount);
+    const char *data = d_ptr->m_count > 0 ? reinterpret_cast<const char*>(d_ptr->m_oids) - sizeof(Header) : 0;
+    QByteArray empty;
+    if (!data) {
+        empty = Private::serialize(QVector<Node>(), QVector<git_oid>());
+        data = empty.constData();
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data, size) != size || !file.commit()) {
+        throw Exception("CommitGraph::write(): could not write " + path + ": " + file.errorString(), Exception::OS);
+    }
+}
+
+int CommitGraph::count() const
+{
+    return int(d_ptr->m_count);
+}
+
+bool CommitGraph::contains(const OId& oid) const
+{
+    return d_ptr->find(oid.constData()) >= 0;
+}
+
+unsigned int CommitGraph::generation(const OId& oid) const
+{
+    int i = d_ptr->find(oid.constData());
+    return i >= 0 ? d_ptr->m_records[i].generation : 0;
+}
+
+bool CommitGraph::isAncestor(const OId& ancestor, const OId& descendant) const
+{
+    int a = d_ptr->find(ancestor.constData());
+    int d = d_ptr->find(descendant.constData());
+    if (a < 0 || d < 0) {
+        return ancestor == descendant ||
+               qGitThrow(git_graph_descendant_of(d_ptr->m_repo.data(), descendant.constData(), ancestor.constData())) == 1;
+    }
+    return d_ptr->isAncestor(quint32(a), quint32(d));
+}
+
+OId CommitGraph::mergeBase(const OId& one, const OId& two) const
+{
+    int a = d_ptr->find(one.constData());
+    int b = d_ptr->find(two.constData());
+    if (a < 0 || b < 0) {
+        OId out;
+        qGitThrow(git_merge_base(out.data(), d_ptr->m_repo.data(), one.constData(), two.constData()));
+        return out;
+    }
+
+    int base = d_ptr->mergeBase(quint32(a), quint32(b));
+    if (base < 0) {
+        throw Exception("CommitGraph::mergeBase(): no merge base found", Exception::Merge);
+    }
+    return OId(&d_ptr->m_oids[base]);
+}
+
+Repository::GraphRelationship CommitGraph::aheadBehind(const OId& local, const OId& upstream) const
+{
+    int l = d_ptr->find(local.constData());
+    int u = d_ptr->find(upstream.constData());
+    if (l < 0 || u < 0) {
+        Repository::GraphRelationship result;
+        qGitThrow(git_graph_ahead_behind(&result.ahead, &result.behind, d_ptr->m_repo.data(), local.constData(), upstream.constData()));
+        return result;
+    }
+    return d_ptr->aheadBehind(quint32(l), quint32(u));
+}
+
+} // namespace LibQGit2
@@ -0,0 +1,135 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_COMMITGRAPH_H
+#define LIBQGIT2_COMMITGRAPH_H
+
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+
+#include "qgitrepository.h"
+
+#include "libqgit2_export.h"
+
+namespace LibQGit2
+{
+    class OId;
+
+    /**
+     * @brief An index of the commit history of a repository.
+     *
+     * The graph stores, for every commit reachable from the references of the
+     * repository, its id, its parents, its commit time and its generation number
+     * (one more than the largest generation of its parents). It is kept in a file
+     * inside the repository directory which is memory-mapped when loaded, so ancestry
+     * queries neither parse commits nor allocate per commit.
+     *
+     * The generation numbers allow to stop a walk as soon as the remaining commits
+     * can not be ancestors of the searched one. Queries involving a commit that is not
+     * in the graph are answered by libgit2 instead; call update() to add new commits.
+     *
+     * @ingroup LibQGit2
+     * @{
+     */
+    class LIBQGIT2_EXPORT CommitGraph
+    {
+        public:
+            /**
+             * Creates an empty graph for \a repository. Call load() or update() to fill it.
+             */
+            explicit CommitGraph(const Repository& repository);
+
+            ~CommitGraph();
+
+            /**
+             * The path of the file the graph of \a repository is stored in.
+             */
+            static QString defaultPath(const Repository& repository);
+
+            /**
+             * Loads the graph from its file.
+             *
+             * @return false if the file does not exist or is not a valid graph file; the
+             * graph is then empty.
+             */
+            bool load();
+
+            /**
+             * Adds the commits reachable from the references and HEAD that are not yet in
+             * the graph, and writes the graph to its file.
+             *
+             * @throws LibQGit2::Exception
+             */
+            void update();
+
+            /**
+             * Writes the graph to \a path.
+             *
+             * @throws LibQGit2::Exception
+             */
+            void write(const QString& path) const;
+
+            /**
+             * Returns the number of commits in the graph.
+             */
+            int count() const;
+
+            /**
+             * Returns true if the commit with the given id is in the graph.
+             */
+            bool contains(const OId& oid) const;
+
+            /**
+             * Returns the generation number of the commit with the given id, or 0 if it is
+             * not in the graph. Root commits have the generation 1.
+             */
+            unsigned int generation(const OId& oid) const;
+
+            /**
+             * Checks if \a ancestor is reachable from \a descendant. A commit is considered
+             * to be an ancestor of itself.
+             *
+             * @throws LibQGit2::Exception
+             */
+            bool isAncestor(const OId& ancestor, const OId& descendant) const;
+
+            /**
+             * Finds a merge base between two commits.
+             *
+             * @throws LibQGit2::Exception if there is no merge base.
+             */
+            OId mergeBase(const OId& one, const OId& two) const;
+
+            /**
+             * Counts the commits \a local is ahead of and behind \a upstream.
+             *
+             * @see Repository::commitRelationship()
+             * @throws LibQGit2::Exception
+             */
+            Repository::GraphRelationship aheadBehind(const OId& local, const OId& upstream) const;
+
+        private:
+            class Private;
+            QSharedPointer<Private> d_ptr;
+            Q_DECLARE_PRIVATE()
+    };
+
+    /**@}*/
+}
+
+#endif // LIBQGIT2_COMMITGRAPH_H
@@ -18,6 +18,113 @@
 
 #include "qgitdiff.h"
 #include "qgitdiffdelta.h"
+#include "qgitdiffhunk.h"
+#include "qgitdiffline.h"
+#include "qgitdiffpatch.h"
+#include "qgitdiffstats.h"
+#include "qgitexception.h"
+#include "qgitrenameoptions.h"
+#include "qgitrepository.h"
+#include "private/workerpool.h"
+
+#include <exception>
+
+namespace {
+
+bool isBlobFile(const git_diff_file &file)
+{
+    // without a valid id the side is a working directory file that was not hashed
+    return (file.flags & GIT_DIFF_FLAG_VALID_ID) &&
+           (file.mode == GIT_FILEMODE_BLOB || file.mode == GIT_FILEMODE_BLOB_EXECUTABLE || file.mode == GIT_FILEMODE_LINK);
+}
+
+/**
+ * Returns true if the patch of \a delta may be computed from blobs. The blobs of
+ * the working directory side of a diff may still be missing from the object
+ * database; lookupBlob() tells.
+ */
+bool isBlobDelta(const git_diff_delta *delta)
+{
+    switch (delta->status) {
+    case GIT_DELTA_ADDED:
+        return isBlobFile(delta->new_file);
+    case GIT_DELTA_DELETED:
+        return isBlobFile(delta->old_file);
+    case GIT_DELTA_MODIFIED:
+    case GIT_DELTA_RENAMED:
+    case GIT_DELTA_COPIED:
+        return isBlobFile(delta->old_file) && isBlobFile(delta->new_file);
+    default:
+        return false;
+    }
+}
+
+/**
+ * Looks up the blob of \a file into \a blob.
+ *
+ * @return false if the blob is not in the object database, which is the case for
+ * working directory files that libgit2 hashed but did not store.
+ */
+bool lookupBlob(git_repository *repo, const git_diff_file &file, git_blob **blob)
+{
+    int error = git_blob_lookup(blob, repo, &file.id);
+    if (error == GIT_ENOTFOUND) {
+        giterr_clear();
+        return false;
+    }
+    LibQGit2::qGitThrow(error);
+    return true;
+}
+
+struct ForEachPayload {
+    const LibQGit2::Diff::FileCallback &file;
+    const LibQGit2::Diff::HunkCallback &hunk;
+    const LibQGit2::Diff::LineCallback &line;
+    bool stopped;
+    std::exception_ptr error;
+};
+
+// The callbacks must not let exceptions through libgit2.
+template <typename F>
+int invoke(ForEachPayload *payload, F f)
+{
+    try {
+        if (!f()) {
+            payload->stopped = true;
+            return GIT_EUSER;
+        }
+    } catch (...) {
+        payload->error = std::current_exception();
+        return GIT_EUSER;
+    }
+    return 0;
+}
+
+int fileCallback(const git_diff_delta *delta, float progress, void *data)
+{
+    ForEachPayload *payload = static_cast<ForEachPayload*>(data);
+    return invoke(payload, [&]() {
+        return !payload->file || payload->file(LibQGit2::DiffDelta(delta), progress);
+    });
+}
+
+int hunkCallback(const git_diff_delta *delta, const git_diff_hunk *hunk, void *data)
+{
+    ForEachPayload *payload = static_cast<ForEachPayload*>(data);
+    return invoke(payload, [&]() {
+        return !payload->hunk || payload->hunk(LibQGit2::DiffDelta(delta), LibQGit2::DiffHunk(hunk));
+    });
+}
+
+int lineCallback(const git_diff_delta *delta, const git_diff_hunk *hunk, const git_diff_line *line, void *data)
+{
+    ForEachPayload *payload = static_cast<ForEachPayload*>(data);
+    return invoke(payload, [&]() {
+        return payload->line(LibQGit2::DiffDelta(delta), LibQGit2::DiffHunk(hunk), LibQGit2::DiffLine(line));
+    });
+}
+
+}
 
 namespace LibQGit2
 {
@@ -25,6 +132,19 @@ namespace LibQGit2
 Diff::Diff(git_diff *diff) :
     d(diff, git_diff_free)
 {
+    git_diff_options temp = GIT_DIFF_OPTIONS_INIT;
+    m_patchOptions = temp;
+}
+
+Diff::Diff(git_diff *diff, const DiffOptions &options) :
+    d(diff, git_diff_free),
+    m_patchOptions(*options.data())
+{
+    // the paths only restrict which deltas are made, and are owned by the options
+    m_patchOptions.pathspec.strings = NULL;
+    m_patchOptions.pathspec.count = 0;
+    // the deltas of a reversed diff have their sides swapped already
+    m_patchOptions.flags &= ~GIT_DIFF_REVERSE;
 }
 
 size_t Diff::numDeltas() const
@@ -45,4 +165,140 @@ DiffDelta Diff::delta(size_t index) const
     return DiffDelta(delta);
 }
 
+void Diff::forEach(const FileCallback &fileCb, const HunkCallback &hunkCb, const LineCallback &lineCb) const
+{
+    if (d.isNull()) {
+        return;
+    }
+
+    ForEachPayload payload = { fileCb, hunkCb, lineCb, false, std::exception_ptr() };
+    // a hunk callback is needed to get the lines
+    const bool wantHunks = hunkCb || lineCb;
+    int error = git_diff_foreach(d.data(), fileCallback, NULL,
+                                 wantHunks ? hunkCallback : NULL,
+                                 lineCb ? lineCallback : NULL,
+                                 &payload);
+    if (payload.error) {
+        std::rethrow_exception(payload.error);
+    }
+    if (error == GIT_EUSER && payload.stopped) {
+        return;
+    }
+    qGitThrow(error);
+}
+
+QVector<DiffPatch> Diff::generatePatchesParallel(const Repository &repository, int threadCount) const
+{
+    const int count = int(numDeltas());
+    QVector<DiffPatch> patches(count);
+
+    QVector<const git_diff_delta*> deltas(count);
+    QVector<int> parallel;
+    QVector<int> serial;
+    for (int i = 0; i < count; ++i) {
+        deltas[i] = git_diff_get_delta(d.data(), i);
+        if (isBlobDelta(deltas[i])) {
+            parallel.append(i);
+        } else {
+            serial.append(i);
+        }
+    }
+
+    // the deltas whose blobs turn out to be missing are left to patch()
+    QVector<char> missing(count, 0);
+    if (!parallel.isEmpty()) {
+        internal::WorkerPool pool(repository.path(), threadCount);
+        DiffPatch *out = patches.data();
+        char *missed = missing.data();
+        const git_diff_delta * const *in = deltas.constData();
+        const int *jobs = parallel.constData();
+        const git_diff_options *opts = &m_patchOptions;
+        pool.run(parallel.size(), [out, missed, in, jobs, opts](internal::WorkerPool::Worker &worker, int job) {
+            const git_diff_delta *delta = in[jobs[job]];
+            const bool hasOld = delta->status != GIT_DELTA_ADDED;
+            const bool hasNew = delta->status != GIT_DELTA_DELETED;
+
+            git_blob *oldBlob = 0;
+            git_blob *newBlob = 0;
+            if (hasOld && !lookupBlob(worker.handle.data(), delta->old_file, &oldBlob)) {
+                missed[jobs[job]] = 1;
+                return;
+            }
+            try {
+                if (hasNew && !lookupBlob(worker.handle.data(), delta->new_file, &newBlob)) {
+                    git_blob_free(oldBlob);
+                    missed[jobs[job]] = 1;
+                    return;
+                }
+            } catch (...) {
+                git_blob_free(oldBlob);
+                throw;
+            }
+
+            git_patch *patch = 0;
+            int error = git_patch_from_blobs(&patch, oldBlob, delta->old_file.path,
+                                             newBlob, delta->new_file.path, opts);
+            if (error < 0) {
+                git_blob_free(oldBlob);
+                git_blob_free(newBlob);
+                qGitThrow(error);
+            }
+
+            // the lines of the patch point into the blobs, which belong to the worker handle
+            QSharedPointer<git_repository> handle = worker.handle;
+            out[jobs[job]] = DiffPatch(QSharedPointer<git_patch>(patch, [oldBlob, newBlob, handle](git_patch *p) {
+                git_patch_free(p);
+                git_blob_free(oldBlob);
+                git_blob_free(newBlob);
+            }));
+        });
+    }
+
+    foreach (int i, parallel) {
+        if (missing[i]) {
+            patches[i] = patch(size_t(i));
+        }
+    }
+    foreach (int i, serial) {
+        patches[i] = patch(size_t(i));
+    }
+
+    return patches;
+}
+
+void Diff::findRenames(const RenameOptions &opts)
+{
+    if (!d.isNull()) {
+        qGitThrow(git_diff_find_similar(d.data(), opts.data()));
+    }
+}
+
+DiffStats Diff::stats() const
+{
+    DiffStats result;
+    const size_t count = numDeltas();
+    result.reserve(int(count));
+    for (size_t i = 0; i < count; ++i) {
+        git_patch *patch = NULL;
+        qGitThrow(git_patch_from_diff(&patch, d.data(), i));
+        size_t insertions = 0, deletions = 0;
+        if (patch) {
+            int error = git_patch_line_stats(NULL, &insertions, &deletions, patch);
+            git_patch_free(patch);
+            qGitThrow(error);
+        }
+        result.append(git_diff_get_delta(d.data(), i)->new_file.path, insertions, deletions);
+    }
+    return result;
+}
+
+DiffPatch Diff::patch(size_t index) const
+{
+    git_patch *patch = NULL;
+    if (!d.isNull()) {
+        qGitThrow(git_patch_from_diff(&patch, d.data(), index));
+    }
+    return DiffPatch(patch);
+}
+
 }
@@ -20,15 +20,25 @@
 #define LIBQGIT2_DIFF_H
 
 #include <QSharedPointer>
+#include <QVector>
+
+#include <functional>
 
 #include "git2.h"
 
 #include "libqgit2_export.h"
+#include "qgitdiffoptions.h"
 
 namespace LibQGit2
 {
 
 class DiffDelta;
+class DiffHunk;
+class DiffLine;
+class DiffPatch;
+class DiffStats;
+class RenameOptions;
+class Repository;
 
 /**
  * This class represents a diff.
@@ -38,6 +48,12 @@ class LIBQGIT2_EXPORT Diff
 public:
     Diff(git_diff *diff = 0);
 
+    /**
+     * Wraps \a diff, which was made with \a options. The options are reused to
+     * compute the text diffs in generatePatchesParallel().
+     */
+    Diff(git_diff *diff, const DiffOptions &options);
+
     /**
      * @brief Get the number of \c DiffDelta objects in this \c Diff.
      */
@@ -54,8 +70,92 @@ public:
      */
     DiffDelta delta(size_t index) const;
 
+    /**
+     * Called for every file of the diff with its delta and the progress of the
+     * iteration (between 0 and 1). Return false to stop the iteration.
+     */
+    typedef std::function<bool(const DiffDelta &delta, float progress)> FileCallback;
+
+    /**
+     * Called for every hunk of a file. Return false to stop the iteration.
+     */
+    typedef std::function<bool(const DiffDelta &delta, const DiffHunk &hunk)> HunkCallback;
+
+    /**
+     * Called for every line of a hunk. Return false to stop the iteration.
+     */
+    typedef std::function<bool(const DiffDelta &delta, const DiffHunk &hunk, const DiffLine &line)> LineCallback;
+
+    /**
+     * @brief Goes through the files, hunks and lines of this \c Diff.
+     *
+     * The text diff of a file is computed only when it is needed, i.e. when
+     * \a hunkCallback or \a lineCallback is set, and only one file at a time is
+     * kept in memory. The objects passed to the callbacks are only valid during
+     * the call.
+     *
+     * An exception thrown by a callback stops the iteration and is rethrown.
+     *
+     * @throws LibQGit2::Exception
+     */
+    void forEach(const FileCallback &fileCallback,
+                 const HunkCallback &hunkCallback = HunkCallback(),
+                 const LineCallback &lineCallback = LineCallback()) const;
+
+    /**
+     * @brief Computes the text diff of the delta at \a index.
+     *
+     * @param index an index from the interval 0 <= index < numDeltas().
+     * @return the patch; a null patch for an unmodified, binary or ignored delta.
+     * @throws LibQGit2::Exception
+     */
+    DiffPatch patch(size_t index) const;
+
+    /**
+     * @brief Turns the matching deletions and additions of this \c Diff into renames or copies.
+     *
+     * The deltas are modified in place, which affects all the copies of this
+     * \c Diff. Matching is done by content similarity, see RenameOptions.
+     *
+     * @throws LibQGit2::Exception
+     */
+    void findRenames(const RenameOptions &opts);
+
+    /**
+     * @brief Counts the added and deleted lines of every delta.
+     *
+     * The hunks of one delta at a time are computed and counted; neither the patch
+     * text nor the lines are kept.
+     *
+     * @throws LibQGit2::Exception
+     */
+    DiffStats stats() const;
+
+    /**
+     * @brief Computes the text diffs of all the deltas on several threads.
+     *
+     * The blobs of each delta are loaded and diffed by worker threads, each one
+     * with its own handle on \a repository, which must be the repository of this
+     * diff. Deltas with a side that is not in the object database (e.g. the working
+     * directory) are diffed on the calling thread instead, as by patch().
+     *
+     * The delta of a patch computed from blobs has the paths and ids of the delta
+     * of this diff, but reports renamed and copied files as modified. The blobs are
+     * diffed with the flags and context settings this diff was made with.
+     *
+     * @param repository the repository the diff was made in
+     * @param threadCount the number of worker threads; the ideal thread count of
+     * the machine is used when less than 1.
+     * @return one patch per delta, in delta order; see patch().
+     * @throws LibQGit2::Exception
+     */
+    QVector<DiffPatch> generatePatchesParallel(const Repository &repository, int threadCount = 0) const;
+
 public:
     QSharedPointer<git_diff> d;
+
+private:
+    git_diff_options m_patchOptions;
 };
 
 }
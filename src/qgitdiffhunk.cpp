@@ -0,0 +1,55 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitdiffhunk.h"
+
+namespace LibQGit2 {
+
+DiffHunk::DiffHunk(const git_diff_hunk *hunk) : m_diff_hunk(hunk)
+{
+}
+
+int DiffHunk::oldStart() const
+{
+    return m_diff_hunk != NULL ? m_diff_hunk->old_start : 0;
+}
+
+int DiffHunk::oldLines() const
+{
+    return m_diff_hunk != NULL ? m_diff_hunk->old_lines : 0;
+}
+
+int DiffHunk::newStart() const
+{
+    return m_diff_hunk != NULL ? m_diff_hunk->new_start : 0;
+}
+
+int DiffHunk::newLines() const
+{
+    return m_diff_hunk != NULL ? m_diff_hunk->new_lines : 0;
+}
+
+QByteArray DiffHunk::header() const
+{
+    if (m_diff_hunk == NULL) {
+        return QByteArray();
+    }
+    return QByteArray::fromRawData(m_diff_hunk->header, int(m_diff_hunk->header_len));
+}
+
+}
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_DIFFHUNK_H
+#define LIBQGIT2_DIFFHUNK_H
+
+#include <QByteArray>
+
+#include "libqgit2_export.h"
+
+#include "git2.h"
+
+namespace LibQGit2 {
+
+/**
+ * @brief Wrapper class for git_diff_hunk.
+ *
+ * A hunk does not own its data: it is valid as long as the DiffPatch it was
+ * taken from, or during the Diff::forEach() callback it was passed to.
+ *
+ * @ingroup LibQGit2
+ * @{
+ */
+class LIBQGIT2_EXPORT DiffHunk
+{
+public:
+    DiffHunk(const git_diff_hunk *hunk = 0);
+
+    bool isNull() const { return m_diff_hunk == 0; }
+
+    /**
+     * The first line of the hunk in the old file, starting at 1.
+     */
+    int oldStart() const;
+
+    /**
+     * The number of lines of the hunk in the old file.
+     */
+    int oldLines() const;
+
+    /**
+     * The first line of the hunk in the new file, starting at 1.
+     */
+    int newStart() const;
+
+    /**
+     * The number of lines of the hunk in the new file.
+     */
+    int newLines() const;
+
+    /**
+     * Returns the "@@ -a,b +c,d @@" header line, without copying it.
+     */
+    QByteArray header() const;
+
+    const git_diff_hunk* constData() const { return m_diff_hunk; }
+
+private:
+    const git_diff_hunk *m_diff_hunk;
+};
+
+/** @} */
+
+}
+
+#endif // LIBQGIT2_DIFFHUNK_H
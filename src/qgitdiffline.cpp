@@ -0,0 +1,67 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitdiffline.h"
+
+namespace LibQGit2 {
+
+DiffLine::DiffLine(const git_diff_line *line) : m_diff_line(line)
+{
+}
+
+DiffLine::Origin DiffLine::origin() const
+{
+    return m_diff_line != NULL ? Origin(m_diff_line->origin) : Unknown;
+}
+
+int DiffLine::oldLineNumber() const
+{
+    return m_diff_line != NULL ? m_diff_line->old_lineno : -1;
+}
+
+int DiffLine::newLineNumber() const
+{
+    return m_diff_line != NULL ? m_diff_line->new_lineno : -1;
+}
+
+int DiffLine::numLines() const
+{
+    return m_diff_line != NULL ? m_diff_line->num_lines : 0;
+}
+
+qint64 DiffLine::contentOffset() const
+{
+    return m_diff_line != NULL ? qint64(m_diff_line->content_offset) : -1;
+}
+
+const char* DiffLine::contentData() const
+{
+    return m_diff_line != NULL ? m_diff_line->content : 0;
+}
+
+int DiffLine::contentSize() const
+{
+    return m_diff_line != NULL ? int(m_diff_line->content_len) : 0;
+}
+
+QByteArray DiffLine::content() const
+{
+    return QByteArray::fromRawData(contentData(), contentSize());
+}
+
+}
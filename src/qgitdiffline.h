@@ -0,0 +1,106 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_DIFFLINE_H
+#define LIBQGIT2_DIFFLINE_H
+
+#include <QByteArray>
+
+#include "libqgit2_export.h"
+
+#include "git2.h"
+
+namespace LibQGit2 {
+
+/**
+ * @brief Wrapper class for git_diff_line.
+ *
+ * The content of a line is not copied: it points into the buffers of the
+ * diff, so a line is valid as long as the DiffPatch it was taken from, or
+ * during the Diff::forEach() callback it was passed to.
+ *
+ * @ingroup LibQGit2
+ * @{
+ */
+class LIBQGIT2_EXPORT DiffLine
+{
+public:
+    DiffLine(const git_diff_line *line = 0);
+
+    enum Origin {
+        Unknown = 0,
+        Context = GIT_DIFF_LINE_CONTEXT,                 ///< unchanged line
+        Addition = GIT_DIFF_LINE_ADDITION,               ///< line only in the new file
+        Deletion = GIT_DIFF_LINE_DELETION,               ///< line only in the old file
+        ContextEOFNL = GIT_DIFF_LINE_CONTEXT_EOFNL,      ///< both files have no newline at the end
+        AddEOFNL = GIT_DIFF_LINE_ADD_EOFNL,              ///< the old file has a newline at the end, the new one not
+        DelEOFNL = GIT_DIFF_LINE_DEL_EOFNL,              ///< the new file has a newline at the end, the old one not
+        FileHeader = GIT_DIFF_LINE_FILE_HDR,             ///< file header, only when printing a patch
+        HunkHeader = GIT_DIFF_LINE_HUNK_HDR,             ///< hunk header, only when printing a patch
+        Binary = GIT_DIFF_LINE_BINARY                    ///< binary files differ
+    };
+
+    bool isNull() const { return m_diff_line == 0; }
+
+    Origin origin() const;
+
+    /**
+     * The line number in the old file, or -1 for an added line.
+     */
+    int oldLineNumber() const;
+
+    /**
+     * The line number in the new file, or -1 for a deleted line.
+     */
+    int newLineNumber() const;
+
+    /**
+     * The number of newline characters in the content.
+     */
+    int numLines() const;
+
+    /**
+     * The offset of the line in the file it comes from, or -1 for an end of
+     * file marker.
+     */
+    qint64 contentOffset() const;
+
+    /**
+     * The content of the line, including its newline if any. This points into
+     * the buffers of the diff and is not null-terminated.
+     */
+    const char* contentData() const;
+
+    int contentSize() const;
+
+    /**
+     * Returns the content of the line as a QByteArray that does not copy it.
+     */
+    QByteArray content() const;
+
+    const git_diff_line* constData() const { return m_diff_line; }
+
+private:
+    const git_diff_line *m_diff_line;
+};
+
+/** @} */
+
+}
+
+#endif // LIBQGIT2_DIFFLINE_H
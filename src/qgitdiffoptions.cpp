@@ -0,0 +1,125 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitdiffoptions.h"
+#include "private/pathcodec.h"
+#include "private/strarray.h"
+
+namespace LibQGit2
+{
+
+class DiffOptions::Private
+{
+public:
+    Private(Flags flags)
+    {
+        git_diff_options temp = GIT_DIFF_OPTIONS_INIT;
+        native = temp;
+        native.flags = uint32_t(flags);
+
+        git_diff_find_options tempFind = GIT_DIFF_FIND_OPTIONS_INIT;
+        find = tempFind;
+        find.flags = 0;
+    }
+
+    void setPaths(const QList<QString> &paths)
+    {
+        QList<QByteArray> pathByteArrays;
+        pathByteArrays.reserve(paths.size());
+        foreach (const QString &path, paths) {
+            pathByteArrays.append(PathCodec::toLibGit2(path));
+        }
+        m_paths = internal::StrArray(pathByteArrays);
+
+        native.pathspec = m_paths.data();
+    }
+
+    git_diff_options native;
+    git_diff_find_options find;
+    internal::StrArray m_paths;
+};
+
+
+DiffOptions::DiffOptions(Flags flags)
+    : d_ptr(new Private(flags))
+{
+}
+
+DiffOptions::Flags DiffOptions::flags() const
+{
+    return Flags(int(d_ptr->native.flags));
+}
+
+void DiffOptions::setFlags(Flags flags)
+{
+    d_ptr->native.flags = uint32_t(flags);
+}
+
+void DiffOptions::setPaths(const QList<QString> &paths)
+{
+    d_ptr->setPaths(paths);
+}
+
+void DiffOptions::setMaxSize(qint64 size)
+{
+    d_ptr->native.max_size = git_off_t(size);
+}
+
+void DiffOptions::setContextLines(quint32 lines)
+{
+    d_ptr->native.context_lines = lines;
+}
+
+void DiffOptions::setInterhunkLines(quint32 lines)
+{
+    d_ptr->native.interhunk_lines = lines;
+}
+
+void DiffOptions::setRenameThreshold(quint16 threshold)
+{
+    d_ptr->find.flags |= GIT_DIFF_FIND_RENAMES;
+    d_ptr->find.rename_threshold = threshold;
+}
+
+void DiffOptions::setCopyThreshold(quint16 threshold)
+{
+    d_ptr->find.flags |= GIT_DIFF_FIND_COPIES;
+    d_ptr->find.copy_threshold = threshold;
+}
+
+void DiffOptions::setRenameLimit(quint32 limit)
+{
+    d_ptr->find.rename_limit = limit;
+}
+
+bool DiffOptions::findsSimilar() const
+{
+    return d_ptr->find.flags != 0;
+}
+
+const git_diff_options* DiffOptions::data() const
+{
+    return &d_ptr->native;
+}
+
+const git_diff_find_options* DiffOptions::findData() const
+{
+    return findsSimilar() ? &d_ptr->find : 0;
+}
+
+}
@@ -0,0 +1,145 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_DIFFOPTIONS_H
+#define LIBQGIT2_DIFFOPTIONS_H
+
+#include "git2.h"
+#include <QSharedPointer>
+#include <QString>
+#include "libqgit2_export.h"
+
+namespace LibQGit2
+{
+    /**
+     * Options that specify how a diff is computed.
+     *
+     * By default a diff covers the whole trees with three lines of context,
+     * checks the content of the files for binary data and does not look for
+     * renamed or copied files.
+     *
+     * @ingroup LibQGit2
+     * @{
+     */
+    class LIBQGIT2_EXPORT DiffOptions
+    {
+    public:
+        /**
+         * Options specifying details about how a diff is computed.
+         */
+        enum Flag {
+            Reverse = GIT_DIFF_REVERSE,                                 ///< Swap the old and the new sides of the diff
+            IncludeTypeChange = GIT_DIFF_INCLUDE_TYPECHANGE,            ///< Report type changes instead of a deletion and an addition
+            DisablePathspecMatch = GIT_DIFF_DISABLE_PATHSPEC_MATCH,     ///< Match the paths exactly instead of as fnmatch patterns
+            SkipBinaryCheck = GIT_DIFF_SKIP_BINARY_CHECK,               ///< Do not read the file contents to tell binary files apart
+            ForceText = GIT_DIFF_FORCE_TEXT,                            ///< Treat all files as text
+            ForceBinary = GIT_DIFF_FORCE_BINARY,                        ///< Treat all files as binary
+            IgnoreWhitespace = GIT_DIFF_IGNORE_WHITESPACE,              ///< Ignore all whitespace
+            IgnoreWhitespaceChange = GIT_DIFF_IGNORE_WHITESPACE_CHANGE, ///< Ignore changes in the amount of whitespace
+            IgnoreWhitespaceEol = GIT_DIFF_IGNORE_WHITESPACE_EOL,       ///< Ignore whitespace at the end of lines
+            Minimal = GIT_DIFF_MINIMAL,                                 ///< Take extra time to find the smallest diff
+            Patience = GIT_DIFF_PATIENCE,                               ///< Use the patience diff algorithm
+            IncludeUntracked = GIT_DIFF_INCLUDE_UNTRACKED,              ///< Include untracked files of the working directory
+            RecurseUntrackedDirs = GIT_DIFF_RECURSE_UNTRACKED_DIRS,     ///< List the files of untracked directories instead of the directories
+            IncludeIgnored = GIT_DIFF_INCLUDE_IGNORED,                  ///< Include ignored files of the working directory
+            UpdateIndex = GIT_DIFF_UPDATE_INDEX                         ///< Store the refreshed stat data of unchanged files in the index
+        };
+        Q_DECLARE_FLAGS(Flags, Flag)
+
+        /**
+         * Constructs a new DiffOptions.
+         * @param flags Details about the diff process.
+         */
+        DiffOptions(Flags flags = Flags());
+
+        Flags flags() const;
+
+        void setFlags(Flags flags);
+
+        /**
+         * Restricts the diff to the given paths.
+         * These can be exact path names, directories or wildcard matchers like `src/*.c`.
+         * The wildcard syntax is that accepted by the POSIX \c fnmatch function.
+         * Only the subtrees that can match are read.
+         * @param paths The paths to diff.
+         */
+        void setPaths(const QList<QString> &paths);
+
+        /**
+         * Sets the size in bytes above which a file is treated as binary and not diffed.
+         * The default is 512 MB; a negative size disables the limit.
+         */
+        void setMaxSize(qint64 size);
+
+        /**
+         * Sets the number of unchanged lines around each change. The default is 3.
+         */
+        void setContextLines(quint32 lines);
+
+        /**
+         * Sets the maximum number of unchanged lines between two changes for them to
+         * be merged into a single hunk. The default is 0.
+         */
+        void setInterhunkLines(quint32 lines);
+
+        /**
+         * Enables the detection of renamed files.
+         * @param threshold The similarity in percent for a deleted and an added file
+         * to be reported as a rename.
+         */
+        void setRenameThreshold(quint16 threshold = 50);
+
+        /**
+         * Enables the detection of copied files among the modified files.
+         * @param threshold The similarity in percent for a file to be reported as a
+         * copy of a modified file.
+         */
+        void setCopyThreshold(quint16 threshold = 50);
+
+        /**
+         * Sets the maximum number of files to compare with each other when looking for
+         * renames and copies. The default is 200, or the diff.renameLimit setting.
+         */
+        void setRenameLimit(quint32 limit);
+
+        /**
+         * Returns true if renames or copies are detected.
+         */
+        bool findsSimilar() const;
+
+        const git_diff_options* data() const;
+
+        /**
+         * The options for \c git_diff_find_similar(), or 0 if neither renames nor copies
+         * are detected.
+         */
+        const git_diff_find_options* findData() const;
+
+    private:
+        class Private;
+        QSharedPointer<Private> d_ptr;
+        Q_DECLARE_PRIVATE()
+    };
+
+    Q_DECLARE_OPERATORS_FOR_FLAGS(DiffOptions::Flags)
+
+    /** @} */
+
+}
+
+#endif // LIBQGIT2_DIFFOPTIONS_H
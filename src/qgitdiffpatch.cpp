@@ -0,0 +1,111 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitdiffpatch.h"
+#include "qgitdiffdelta.h"
+#include "qgitdiffhunk.h"
+#include "qgitdiffline.h"
+#include "qgitexception.h"
+
+#include "private/buffer.h"
+
+namespace LibQGit2 {
+
+DiffPatch::DiffPatch(git_patch *patch) : d(patch, git_patch_free)
+{
+}
+
+DiffPatch::DiffPatch(const QSharedPointer<git_patch> &patch) : d(patch)
+{
+}
+
+bool DiffPatch::isNull() const
+{
+    return d.isNull();
+}
+
+DiffDelta DiffPatch::delta() const
+{
+    return DiffDelta(d.isNull() ? NULL : git_patch_get_delta(d.data()));
+}
+
+size_t DiffPatch::numHunks() const
+{
+    return d.isNull() ? 0 : git_patch_num_hunks(d.data());
+}
+
+DiffHunk DiffPatch::hunk(size_t index) const
+{
+    const git_diff_hunk *hunk = NULL;
+    if (!d.isNull() && git_patch_get_hunk(&hunk, NULL, d.data(), index) < 0) {
+        hunk = NULL;
+    }
+    return DiffHunk(hunk);
+}
+
+int DiffPatch::numLines(size_t hunkIndex) const
+{
+    int ret = 0;
+    if (!d.isNull()) {
+        ret = qMax(0, git_patch_num_lines_in_hunk(d.data(), hunkIndex));
+    }
+    return ret;
+}
+
+DiffLine DiffPatch::line(size_t hunkIndex, size_t lineIndex) const
+{
+    const git_diff_line *line = NULL;
+    if (!d.isNull() && git_patch_get_line_in_hunk(&line, d.data(), hunkIndex, lineIndex) < 0) {
+        line = NULL;
+    }
+    return DiffLine(line);
+}
+
+void DiffPatch::lineStats(size_t *context, size_t *additions, size_t *deletions) const
+{
+    size_t c = 0, a = 0, r = 0;
+    if (!d.isNull()) {
+        qGitThrow(git_patch_line_stats(&c, &a, &r, d.data()));
+    }
+    if (context) {
+        *context = c;
+    }
+    if (additions) {
+        *additions = a;
+    }
+    if (deletions) {
+        *deletions = r;
+    }
+}
+
+QByteArray DiffPatch::toBuffer() const
+{
+    if (d.isNull()) {
+        return QByteArray();
+    }
+    internal::Buffer buffer;
+    qGitThrow(git_patch_to_buf(buffer.data(), d.data()));
+    return buffer.asQByteArray();
+}
+
+git_patch* DiffPatch::data() const
+{
+    return d.data();
+}
+
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_DIFFPATCH_H
+#define LIBQGIT2_DIFFPATCH_H
+
+#include <QByteArray>
+#include <QSharedPointer>
+
+#include "libqgit2_export.h"
+
+#include "git2.h"
+
+namespace LibQGit2 {
+
+class DiffDelta;
+class DiffHunk;
+class DiffLine;
+
+/**
+ * @brief Wrapper class for git_patch.
+ *
+ * A patch holds the hunks and lines of the text diff of a single delta. The
+ * DiffDelta, DiffHunk and DiffLine objects it returns point into its buffers
+ * and are valid as long as the patch (or a copy of it) exists.
+ *
+ * @ingroup LibQGit2
+ * @{
+ */
+class LIBQGIT2_EXPORT DiffPatch
+{
+public:
+    DiffPatch(git_patch *patch = 0);
+
+    bool isNull() const;
+
+    /**
+     * Returns the delta this patch belongs to.
+     */
+    DiffDelta delta() const;
+
+    size_t numHunks() const;
+
+    /**
+     * Returns the hunk at \a index, or a null hunk if \a index is out of range.
+     */
+    DiffHunk hunk(size_t index) const;
+
+    /**
+     * Returns the number of lines of the hunk at \a hunkIndex, context lines included.
+     */
+    int numLines(size_t hunkIndex) const;
+
+    /**
+     * Returns a line of a hunk, or a null line if an index is out of range.
+     */
+    DiffLine line(size_t hunkIndex, size_t lineIndex) const;
+
+    /**
+     * Counts the context, added and deleted lines of the patch, without going
+     * through the lines one by one.
+     *
+     * @throws LibQGit2::Exception
+     */
+    void lineStats(size_t *context, size_t *additions, size_t *deletions) const;
+
+    /**
+     * Returns the patch in the unified diff format.
+     *
+     * @throws LibQGit2::Exception
+     */
+    QByteArray toBuffer() const;
+
+    git_patch* data() const;
+
+private:
+    explicit DiffPatch(const QSharedPointer<git_patch> &patch);
+
+    QSharedPointer<git_patch> d;
+
+    friend class Diff;
+};
+
+/** @} */
+
+}
+
+#endif // LIBQGIT2_DIFFPATCH_H
@@ -0,0 +1,94 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitdiffstats.h"
+
+#include <QVector>
+
+#include "private/pathcodec.h"
+
+namespace LibQGit2 {
+
+class DiffStats::Private
+{
+public:
+    Private() : m_insertions(0), m_deletions(0) {}
+
+    size_t m_insertions;
+    size_t m_deletions;
+    QVector<size_t> m_fileInsertions;
+    QVector<size_t> m_fileDeletions;
+    QVector<QByteArray> m_paths;
+};
+
+DiffStats::DiffStats() : d_ptr(new Private)
+{
+}
+
+size_t DiffStats::filesChanged() const
+{
+    return size_t(d_ptr->m_paths.size());
+}
+
+size_t DiffStats::insertions() const
+{
+    return d_ptr->m_insertions;
+}
+
+size_t DiffStats::deletions() const
+{
+    return d_ptr->m_deletions;
+}
+
+size_t DiffStats::insertions(size_t index) const
+{
+    return d_ptr->m_fileInsertions.value(int(index));
+}
+
+size_t DiffStats::deletions(size_t index) const
+{
+    return d_ptr->m_fileDeletions.value(int(index));
+}
+
+QByteArray DiffStats::rawPath(size_t index) const
+{
+    return d_ptr->m_paths.value(int(index));
+}
+
+QString DiffStats::path(size_t index) const
+{
+    return PathCodec::fromLibGit2(rawPath(index));
+}
+
+void DiffStats::reserve(int files)
+{
+    d_ptr->m_fileInsertions.reserve(files);
+    d_ptr->m_fileDeletions.reserve(files);
+    d_ptr->m_paths.reserve(files);
+}
+
+void DiffStats::append(const char *path, size_t insertions, size_t deletions)
+{
+    d_ptr->m_insertions += insertions;
+    d_ptr->m_deletions += deletions;
+    d_ptr->m_fileInsertions.append(insertions);
+    d_ptr->m_fileDeletions.append(deletions);
+    d_ptr->m_paths.append(QByteArray(path));
+}
+
+}
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_DIFFSTATS_H
+#define LIBQGIT2_DIFFSTATS_H
+
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QString>
+
+#include "libqgit2_export.h"
+
+#include "git2.h"
+
+namespace LibQGit2 {
+
+/**
+ * @brief The numbers of added and deleted lines of a diff.
+ *
+ * The counts are kept per file of the diff, in delta order, together with the
+ * path of the file. They are computed from the hunks of each file at once;
+ * no patch text is produced. Binary files count as changed without any added or
+ * deleted line.
+ *
+ * @see Diff::stats()
+ *
+ * @ingroup LibQGit2
+ * @{
+ */
+class LIBQGIT2_EXPORT DiffStats
+{
+public:
+    DiffStats();
+
+    /**
+     * Returns the number of changed files.
+     */
+    size_t filesChanged() const;
+
+    /**
+     * Returns the number of added lines in all the files.
+     */
+    size_t insertions() const;
+
+    /**
+     * Returns the number of deleted lines in all the files.
+     */
+    size_t deletions() const;
+
+    /**
+     * Returns the number of added lines of the file at \a index.
+     *
+     * @param index an index from the interval 0 <= index < filesChanged().
+     */
+    size_t insertions(size_t index) const;
+
+    /**
+     * Returns the number of deleted lines of the file at \a index.
+     *
+     * @param index an index from the interval 0 <= index < filesChanged().
+     */
+    size_t deletions(size_t index) const;
+
+    /**
+     * Returns the new path of the file at \a index, as stored by libgit2.
+     */
+    QByteArray rawPath(size_t index) const;
+
+    /**
+     * Returns the new path of the file at \a index.
+     */
+    QString path(size_t index) const;
+
+private:
+    void reserve(int files);
+    void append(const char *path, size_t insertions, size_t deletions);
+
+    class Private;
+    QSharedPointer<Private> d_ptr;
+    Q_DECLARE_PRIVATE()
+
+    friend class Diff;
+};
+
+/** @} */
+
+}
+
+#endif // LIBQGIT2_DIFFSTATS_H
@@ -26,6 +26,152 @@
 #include "qgitrepository.h"
 
 #include "private/pathcodec.h"
+#include "private/strarray.h"
+#include "private/workerpool.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QVector>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+using LibQGit2::Index;
+
+struct MatchPayload {
+    const Index::MatchCallback &callback;
+    bool stopped;
+    std::exception_ptr error;
+};
+
+// The callback must not let exceptions through libgit2.
+int matchCallback(const char *path, const char *matchedPathspec, void *data)
+{
+    MatchPayload *payload = static_cast<MatchPayload*>(data);
+    try {
+        int result = payload->callback(PathCodec::fromLibGit2(path), PathCodec::fromLibGit2(matchedPathspec));
+        if (result < 0) {
+            payload->stopped = true;
+        }
+        return result;
+    } catch (...) {
+        payload->error = std::current_exception();
+        return GIT_EUSER;
+    }
+}
+
+void checkMatch(int error, const MatchPayload &payload)
+{
+    if (payload.error) {
+        std::rethrow_exception(payload.error);
+    }
+    if (error < 0 && !payload.stopped) {
+        LibQGit2::qGitThrow(error);
+    }
+}
+
+LibQGit2::internal::StrArray pathspecArray(const QStringList &pathspecs)
+{
+    QList<QByteArray> paths;
+    foreach (const QString &pathspec, pathspecs) {
+        paths.append(PathCodec::toLibGit2(pathspec));
+    }
+    return LibQGit2::internal::StrArray(paths);
+}
+
+const int StageChunkSize = 64;
+
+/** A file to stage, and the entry the workers make for it. */
+struct StagedFile {
+    QByteArray path;
+    git_index_entry entry;
+    bool prepared;
+    bool deleted;
+};
+
+/**
+ * Returns the mode of the entry of a file of \a mode, keeping the mode of the
+ * \a existing entry as git_index_add_bypath() does when the index capabilities
+ * \a caps tell that the file system does not support executable bits or links.
+ */
+unsigned int entryMode(unsigned int mode, const git_index_entry *existing, int caps)
+{
+    if (mode == GIT_FILEMODE_LINK) {
+        return mode;
+    }
+    if ((caps & GIT_INDEX_CAPABILITY_NO_SYMLINKS) && existing && existing->mode == GIT_FILEMODE_LINK) {
+        return existing->mode;
+    }
+    if (caps & GIT_INDEX_CAPABILITY_NO_FILEMODE) {
+        const bool blob = existing && (existing->mode == GIT_FILEMODE_BLOB || existing->mode == GIT_FILEMODE_BLOB_EXECUTABLE);
+        return blob ? existing->mode : unsigned(GIT_FILEMODE_BLOB);
+    }
+    return mode;
+}
+
+#ifdef Q_OS_UNIX
+
+git_index_time indexTime(const struct timespec &time)
+{
+    git_index_time result;
+    result.seconds = int32_t(time.tv_sec);
+    result.nanoseconds = uint32_t(time.tv_nsec);
+    return result;
+}
+
+/**
+ * Writes the blob of \a file and fills its entry. Anything else than a regular file
+ * or a symbolic link is left to git_index_add_bypath().
+ */
+void prepare(git_repository *repo, const QByteArray &workDir, StagedFile &file)
+{
+    struct stat st;
+    if (::lstat((workDir + file.path).constData(), &st) != 0) {
+        return;
+    }
+
+    git_index_entry &entry = file.entry;
+    if (S_ISREG(st.st_mode)) {
+        entry.mode = (st.st_mode & S_IXUSR) ? GIT_FILEMODE_BLOB_EXECUTABLE : GIT_FILEMODE_BLOB;
+    } else if (S_ISLNK(st.st_mode)) {
+        entry.mode = GIT_FILEMODE_LINK;
+    } else {
+        return;
+    }
+
+    LibQGit2::qGitThrow(git_blob_create_fromworkdir(&entry.id, repo, file.path.constData()));
+
+#if defined(Q_OS_DARWIN)
+    entry.mtime = indexTime(st.st_mtimespec);
+    entry.ctime = indexTime(st.st_ctimespec);
+#else
+    entry.mtime = indexTime(st.st_mtim);
+    entry.ctime = indexTime(st.st_ctim);
+#endif
+    entry.dev = uint32_t(st.st_dev);
+    entry.ino = uint32_t(st.st_ino);
+    entry.uid = uint32_t(st.st_uid);
+    entry.gid = uint32_t(st.st_gid);
+    entry.file_size = uint32_t(st.st_size);
+    entry.path = file.path.constData();
+    file.prepared = true;
+}
+
+#else
+
+void prepare(git_repository *, const QByteArray &, StagedFile &)
+{
+}
+
+#endif
+
+}
 
 namespace LibQGit2
 {
@@ -94,9 +240,123 @@ void Index::add(const IndexEntry &source_entry)
     qGitThrow(git_index_add(data(), source_entry.data()));
 }
 
-void Index::updateAll()
+void Index::addAll(const QStringList &pathspecs, AddFlags flags, const MatchCallback &callback)
+{
+    internal::StrArray paths = pathspecArray(pathspecs);
+    MatchPayload payload = { callback, false, std::exception_ptr() };
+    int error = git_index_add_all(data(), &paths.data(), unsigned(flags),
+                                  callback ? matchCallback : NULL, &payload);
+    checkMatch(error, payload);
+}
+
+void Index::addAllParallel(const QStringList &pathspecs, AddFlags flags, const MatchCallback &callback, int threadCount)
+{
+    git_repository *repo = git_index_owner(data());
+    if (!repo) {
+        throw Exception("Index::addAllParallel(): the index does not belong to a repository");
+    }
+    const Repository repository(repo);
+    const QByteArray workDir = QFile::encodeName(repository.workDirPath());
+    if (workDir.isEmpty()) {
+        throw Exception("Index::addAllParallel(): the repository has no working directory");
+    }
+
+    // find the files to stage by comparing the index with the working directory
+    internal::StrArray paths = pathspecArray(pathspecs);
+    git_diff_options options = GIT_DIFF_OPTIONS_INIT;
+    options.flags = GIT_DIFF_INCLUDE_UNTRACKED | GIT_DIFF_RECURSE_UNTRACKED_DIRS;
+    if (flags.testFlag(AddForce)) {
+        options.flags |= GIT_DIFF_INCLUDE_IGNORED | GIT_DIFF_RECURSE_IGNORED_DIRS;
+    }
+    if (flags.testFlag(AddDisablePathspecMatch)) {
+        options.flags |= GIT_DIFF_DISABLE_PATHSPEC_MATCH;
+    }
+    options.pathspec = paths.data();
+
+    git_diff *diff = 0;
+    qGitThrow(git_diff_index_to_workdir(&diff, repo, data(), &options));
+    QSharedPointer<git_diff> diffPtr(diff, git_diff_free);
+
+    QVector<StagedFile> files;
+    const size_t deltaCount = git_diff_num_deltas(diff);
+    for (size_t i = 0; i < deltaCount; ++i) {
+        const git_diff_delta *delta = git_diff_get_delta(diff, i);
+        switch (delta->status) {
+        case GIT_DELTA_UNTRACKED:
+        case GIT_DELTA_MODIFIED:
+        case GIT_DELTA_TYPECHANGE:
+        case GIT_DELTA_DELETED:
+            break;
+        case GIT_DELTA_IGNORED:
+            if (flags.testFlag(AddForce)) {
+                break;
+            }
+            continue;
+        default:
+            continue;
+        }
+
+        QByteArray path(delta->new_file.path);
+        if (path.endsWith('/')) {
+            continue;   // an empty or nested repository
+        }
+        if (callback) {
+            int result = callback(PathCodec::fromLibGit2(path), QString());
+            if (result < 0) {
+                break;
+            } else if (result > 0) {
+                continue;
+            }
+        }
+
+        StagedFile file;
+        file.path = path;
+        std::memset(&file.entry, 0, sizeof(file.entry));
+        file.prepared = false;
+        file.deleted = delta->status == GIT_DELTA_DELETED;
+        files.append(file);
+    }
+    if (files.isEmpty()) {
+        return;
+    }
+
+    // hash the files and write the blobs
+    internal::WorkerPool pool(repository.path(), threadCount);
+    StagedFile *fileData = files.data();
+    const int size = files.size();
+    pool.run((size + StageChunkSize - 1) / StageChunkSize,
+             [fileData, size, &workDir](internal::WorkerPool::Worker &worker, int chunk) {
+        const int end = qMin(size, (chunk + 1) * StageChunkSize);
+        for (int i = chunk * StageChunkSize; i < end; ++i) {
+            if (!fileData[i].deleted) {
+                prepare(worker.handle.data(), workDir, fileData[i]);
+            }
+        }
+    });
+
+    // insert in path order, as git add does
+    std::sort(files.begin(), files.end(), [](const StagedFile &a, const StagedFile &b) {
+        return std::strcmp(a.path.constData(), b.path.constData()) < 0;
+    });
+    const int caps = git_index_caps(data());
+    for (int i = 0; i < files.size(); ++i) {
+        if (files[i].deleted) {
+            qGitThrow(git_index_remove_bypath(data(), files[i].path.constData()));
+        } else if (files[i].prepared) {
+            files[i].entry.mode = entryMode(files[i].entry.mode, git_index_get_bypath(data(), files[i].path.constData(), 0), caps);
+            qGitThrow(git_index_add(data(), &files[i].entry));
+        } else {
+            qGitThrow(git_index_add_bypath(data(), files[i].path.constData()));
+        }
+    }
+}
+
+void Index::updateAll(const QStringList &pathspecs, const MatchCallback &callback)
 {
-    qGitThrow(git_index_update_all(data(), NULL, NULL, NULL));
+    internal::StrArray paths = pathspecArray(pathspecs);
+    MatchPayload payload = { callback, false, std::exception_ptr() };
+    int error = git_index_update_all(data(), &paths.data(), callback ? matchCallback : NULL, &payload);
+    checkMatch(error, payload);
 }
 
 IndexEntry Index::getByIndex(int n) const
@@ -22,6 +22,9 @@
 #define LIBQGIT2_INDEX_H
 
 #include <QtCore/QSharedPointer>
+#include <QtCore/QStringList>
+
+#include <functional>
 
 #include "git2.h"
 
@@ -42,6 +45,24 @@ namespace LibQGit2
     class LIBQGIT2_EXPORT Index
     {
         public:
+            /**
+             * Options for adding files with addAll().
+             */
+            enum AddFlag {
+                AddDefault = GIT_INDEX_ADD_DEFAULT,
+                AddForce = GIT_INDEX_ADD_FORCE,                                   ///< Add ignored files too
+                AddDisablePathspecMatch = GIT_INDEX_ADD_DISABLE_PATHSPEC_MATCH,   ///< Match the pathspecs as exact paths
+                AddCheckPathspec = GIT_INDEX_ADD_CHECK_PATHSPEC                   ///< Fail on ignored files matching a pathspec exactly, as `git add`
+            };
+            Q_DECLARE_FLAGS(AddFlags, AddFlag)
+
+            /**
+             * Called for every file that is about to be added or updated, with the
+             * pathspec it matched. Return 0 to go on, a positive value to skip the file
+             * and a negative value to stop; the files handled before stay in the index.
+             */
+            typedef std::function<int(const QString &path, const QString &matchedPathspec)> MatchCallback;
+
 
             /**
              * Creates a Index that points to 'index'. The pointer 'index' becomes managed by
@@ -156,10 +177,48 @@ namespace LibQGit2
             void add(const IndexEntry& source_entry);
 
             /**
-             * Update all index entries to match the working directory.
+             * Add or update the index entries of the files matching \a pathspecs.
+             *
+             * Files not in the index are added, the entries of modified files are
+             * updated and those of deleted files are removed, one file after the other;
+             * ignored files are skipped unless \a flags has AddForce.
+             *
+             * @param pathspecs fnmatch patterns or directories; all the files if empty
+             * @param flags options for matching and adding the files
+             * @param callback called for each file before it is added; see MatchCallback
+             * @throws LibQGit2::Exception, or whatever \a callback throws
+             */
+            void addAll(const QStringList &pathspecs = QStringList(), AddFlags flags = AddDefault,
+                        const MatchCallback &callback = MatchCallback());
+
+            /**
+             * Add or update the index entries of the files matching \a pathspecs on
+             * several threads.
+             *
+             * Does the same as addAll(), except that AddCheckPathspec is not supported.
+             * The new, modified and deleted files are found by comparing this index with the
+             * working directory. \a callback is called for all of them first, on the calling
+             * thread, with an empty matched pathspec. Then worker threads hash the files and
+             * write the blobs, each one with its own handle on the repository, and finally
+             * the entries are put into the index in path order, or removed from it. As with
+             * addAll(), the modes of the entries follow core.filemode and core.symlinks.
+             *
+             * @param threadCount the number of worker threads; the ideal thread count of
+             * the machine is used when less than 1.
+             * @throws LibQGit2::Exception
+             */
+            void addAllParallel(const QStringList &pathspecs = QStringList(), AddFlags flags = AddDefault,
+                                const MatchCallback &callback = MatchCallback(), int threadCount = 0);
+
+            /**
+             * Update the index entries matching \a pathspecs to match the working directory.
+             * Entries of deleted files are removed.
+             *
+             * @param pathspecs fnmatch patterns or directories; all the entries if empty
+             * @param callback called for each entry before it is updated; see MatchCallback
              * @throws LibQGit2::Exception
              */
-            void updateAll();
+            void updateAll(const QStringList &pathspecs = QStringList(), const MatchCallback &callback = MatchCallback());
 
             /**
              * Get a pointer to one of the entries in the index
@@ -194,6 +253,8 @@ namespace LibQGit2
             ptr_type d;
     };
 
+    Q_DECLARE_OPERATORS_FOR_FLAGS(Index::AddFlags)
+
     /**@}*/
 }
 
@@ -20,27 +20,147 @@
 
 #include "qgitindexmodel.h"
 
-#include <qgitindexentry.h>
+#include <QVector>
+
+#include <algorithm>
+#include <cstring>
+
+#include "private/pathcodec.h"
 
 namespace LibQGit2
 {
 
+namespace {
+    /** The decoded roles of a row, and what tells whether the entry changed. */
+    struct Row {
+        QByteArray rawPath;
+        QString path;
+        git_oid id;
+        qint64 fileSize;
+        quint32 mode;
+        int stage;
+    };
+
+    Row makeRow(const git_index_entry *entry)
+    {
+        Row row;
+        row.rawPath = QByteArray(entry->path);
+        row.path = PathCodec::fromLibGit2(row.rawPath);
+        git_oid_cpy(&row.id, &entry->id);
+        row.fileSize = entry->file_size;
+        row.mode = entry->mode;
+        row.stage = GIT_INDEX_ENTRY_STAGE(entry);
+        return row;
+    }
+
+    int asciiToLower(unsigned char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+    }
+
+    /**
+     * Compares \a a and \a b ignoring the case of ASCII letters only, as libgit2
+     * sorts an index on a case-insensitive file system.
+     */
+    int asciiCaseCompare(const char *a, const char *b)
+    {
+        while (*a && *b && asciiToLower(uchar(*a)) == asciiToLower(uchar(*b))) {
+            ++a;
+            ++b;
+        }
+        return asciiToLower(uchar(*a)) - asciiToLower(uchar(*b));
+    }
+
+    bool sameData(const Row &row, const git_index_entry *entry)
+    {
+        return git_oid_equal(&row.id, &entry->id) && row.fileSize == qint64(entry->file_size) &&
+               row.mode == entry->mode;
+    }
+}
+
+class IndexModel::Private
+{
+public:
+    explicit Private(const Index &index) :
+        m_index(index),
+        m_count(0),
+        m_batchSize(1024)
+    {
+    }
+
+    int entryCount() const
+    {
+        return m_index.data() ? int(m_index.entryCount()) : 0;
+    }
+
+    const git_index_entry* entry(int i) const
+    {
+        return git_index_get_byindex(m_index.data(), size_t(i));
+    }
+
+    /**
+     * Returns true if the entries of the index moved since it was last looked at:
+     * their number changed, or the last row is no longer at its position.
+     */
+    bool isStale() const
+    {
+        const int count = entryCount();
+        if (count != m_count) {
+            return true;
+        }
+        const int last = m_rows.size() - 1;
+        return last >= 0 && (last >= count || compare(m_rows.at(last), entry(last)) != 0);
+    }
+
+    /** Compares a row and an entry in the order of the index. */
+    int compare(const Row &row, const git_index_entry *entry) const
+    {
+        const bool ignoreCase = git_index_caps(m_index.data()) & GIT_INDEX_CAPABILITY_IGNORE_CASE;
+        int cmp = ignoreCase ? asciiCaseCompare(row.rawPath.constData(), entry->path) :
+                               std::strcmp(row.rawPath.constData(), entry->path);
+        return cmp != 0 ? cmp : row.stage - GIT_INDEX_ENTRY_STAGE(entry);
+    }
+
+    Index m_index;
+    QVector<Row> m_rows;
+
+    // the number of entries of the index when it was last looked at
+    int m_count;
+    int m_batchSize;
+};
+
 IndexModel::IndexModel(const Index& index, QObject *parent)
     : QAbstractListModel(parent)
-    , m_index(index)
+    , d_ptr(new Private(index))
 {
+    d_ptr->m_count = d_ptr->entryCount();
+    const int count = qMin(d_ptr->m_count, d_ptr->m_batchSize);
+    d_ptr->m_rows.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        d_ptr->m_rows.append(makeRow(d_ptr->entry(i)));
+    }
 }
 
 IndexModel::~IndexModel()
 {
 }
 
+int IndexModel::batchSize() const
+{
+    return d_ptr->m_batchSize;
+}
+
+void IndexModel::setBatchSize(int size)
+{
+    d_ptr->m_batchSize = qMax(1, size);
+}
+
 int IndexModel::rowCount(const QModelIndex& parent) const
 {
     if (parent.isValid()) {
         return 0;
     } else {
-        return m_index.entryCount();
+        return d_ptr->m_rows.size();
     }
 }
 
@@ -49,15 +169,141 @@ QVariant IndexModel::data(const QModelIndex& index, int role) const
     if (index.parent().isValid())
         return QVariant();
 
-    if (index.column() != 0)
+    if (index.column() != 0 || index.row() < 0 || index.row() >= d_ptr->m_rows.size())
         return QVariant();
 
-    if (role == Qt::DisplayRole || role == Qt::EditRole) {
-        IndexEntry entry = m_index.getByIndex(index.row());
-        return entry.path();
-    } else {
+    const Row &row = d_ptr->m_rows.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+    case PathRole:
+        return row.path;
+    case IdRole:
+        return QString::fromLatin1(OId(&row.id).format());
+    case FileSizeRole:
+        return row.fileSize;
+    case StageRole:
+        return row.stage;
+    default:
         return QVariant();
     }
 }
 
+QHash<int, QByteArray> IndexModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = QAbstractListModel::roleNames();
+    roles.insert(PathRole, "path");
+    roles.insert(IdRole, "id");
+    roles.insert(FileSizeRole, "fileSize");
+    roles.insert(StageRole, "stage");
+    return roles;
+}
+
+bool IndexModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && d_ptr->m_rows.size() < d_ptr->m_count;
+}
+
+void IndexModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    // the entries are read by position: if the index changed since it was last
+    // looked at, the rows read so far are brought up to date first, so that the
+    // next entry to read is the one after the last row
+    if (d_ptr->isStale()) {
+        refresh();
+    }
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    const int first = d_ptr->m_rows.size();
+    const int last = qMin(d_ptr->m_count, first + d_ptr->m_batchSize) - 1;
+    beginInsertRows(QModelIndex(), first, last);
+    d_ptr->m_rows.reserve(last + 1);
+    for (int i = first; i <= last; ++i) {
+        d_ptr->m_rows.append(makeRow(d_ptr->entry(i)));
+    }
+    endInsertRows();
+}
+
+OId IndexModel::id(int row) const
+{
+    return row >= 0 && row < d_ptr->m_rows.size() ? OId(&d_ptr->m_rows.at(row).id) : OId();
+}
+
+QByteArray IndexModel::rawPath(int row) const
+{
+    return row >= 0 && row < d_ptr->m_rows.size() ? d_ptr->m_rows.at(row).rawPath : QByteArray();
+}
+
+void IndexModel::refresh()
+{
+    Private *d = d_ptr.data();
+    const bool complete = d->m_rows.size() == d->m_count;
+    const int count = d->entryCount();
+
+    // the rows and the entries are both sorted, so a merge finds the differences;
+    // the entries after the last row stay unread unless all the rows were read
+    int row = 0;
+    int i = 0;
+    int changedFirst = -1;
+    int changedLast = -1;
+    while (row < d->m_rows.size() || (complete && i < count)) {
+        const int cmp = row == d->m_rows.size() ? 1 :
+                        i == count ? -1 : d->compare(d->m_rows.at(row), d->entry(i));
+
+        if (cmp == 0) {
+            if (!sameData(d->m_rows.at(row), d->entry(i))) {
+                if (changedLast != row - 1) {
+                    if (changedFirst >= 0) {
+                        emit dataChanged(index(changedFirst), index(changedLast));
+                    }
+                    changedFirst = row;
+                }
+                changedLast = row;
+                d->m_rows[row] = makeRow(d->entry(i));
+            }
+            ++row;
+            ++i;
+            continue;
+        }
+
+        // the rows change below, so the pending changes are signalled first
+        if (changedFirst >= 0) {
+            emit dataChanged(index(changedFirst), index(changedLast));
+            changedFirst = -1;
+            changedLast = -1;
+        }
+
+        if (cmp < 0) {
+            int end = row + 1;
+            while (end < d->m_rows.size() && (i == count || d->compare(d->m_rows.at(end), d->entry(i)) < 0)) {
+                ++end;
+            }
+            beginRemoveRows(QModelIndex(), row, end - 1);
+            d->m_rows.remove(row, end - row);
+            endRemoveRows();
+        } else {
+            QVector<Row> inserted;
+            do {
+                inserted.append(makeRow(d->entry(i++)));
+            } while (i < count && (row == d->m_rows.size() ? complete : d->compare(d->m_rows.at(row), d->entry(i)) > 0));
+            beginInsertRows(QModelIndex(), row, row + inserted.size() - 1);
+            d->m_rows.insert(row, inserted.size(), Row());
+            std::copy(inserted.constBegin(), inserted.constEnd(), d->m_rows.begin() + row);
+            endInsertRows();
+            row += inserted.size();
+        }
+    }
+    if (changedFirst >= 0) {
+        emit dataChanged(index(changedFirst), index(changedLast));
+    }
+
+    d->m_count = count;
+}
+
 }
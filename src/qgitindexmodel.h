@@ -22,28 +22,88 @@
 #define LIBQGIT2_INDEX_MODEL_H
 
 #include "qgitindex.h"
+#include "qgitoid.h"
 
 #include <QAbstractListModel>
+#include <QSharedPointer>
 
 namespace LibQGit2
 {
 
+/**
+ * @brief A list model of the entries of an Index.
+ *
+ * The rows are read from the index in batches, as views ask for more with
+ * fetchMore(), and the roles of a row are decoded once, when it is read. Call
+ * refresh() after changing the index: the rows read so far are compared with the
+ * entries of the index and only the differences are signalled, so views keep
+ * their selection and scroll position.
+ *
+ * @ingroup LibQGit2
+ * @{
+ */
 class LIBQGIT2_EXPORT IndexModel : public QAbstractListModel
 {
     Q_OBJECT
 
 public:
+    enum Role {
+        PathRole = Qt::UserRole + 1,    ///< the path, a QString; also the display role
+        IdRole,                         ///< the hexadecimal id of the blob, a QString
+        FileSizeRole,                   ///< the size of the file, a qint64
+        StageRole                       ///< the merge stage, an int
+    };
+
+    /**
+     * Creates a model of \a index and reads the first batch of entries.
+     */
     explicit IndexModel(const Index& index, QObject *parent = 0);
     ~IndexModel();
 
+    /**
+     * Returns the number of entries read by fetchMore() at a time; 1024 by default.
+     */
+    int batchSize() const;
+
+    /**
+     * Sets the number of entries read by fetchMore() at a time.
+     */
+    void setBatchSize(int size);
+
     int rowCount(const QModelIndex& parent) const;
 
     QVariant data(const QModelIndex& index, int role) const;
 
+    QHash<int, QByteArray> roleNames() const;
+
+    bool canFetchMore(const QModelIndex& parent) const;
+
+    void fetchMore(const QModelIndex& parent);
+
+    /**
+     * Returns the id of the entry at \a row, or an invalid OId.
+     */
+    OId id(int row) const;
+
+    /**
+     * Returns the path of the entry at \a row as stored in the index.
+     */
+    QByteArray rawPath(int row) const;
+
+public slots:
+    /**
+     * Compares the rows with the entries of the index, and updates them with
+     * signals for the inserted, removed and changed rows. The rows that were not
+     * read yet stay to be fetched.
+     */
+    void refresh();
+
 private:
-    Index m_index;
+    class Private;
+    QSharedPointer<Private> d_ptr;
 };
 
+/**@}*/
 }
 
 #endif // LIBQGIT2_INDEX_MODEL_H
@@ -0,0 +1,734 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitindexview.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QVector>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+#include "qgitexception.h"
+#include "qgitrepository.h"
+#include "private/ewah.h"
+#include "private/pathcodec.h"
+
+namespace LibQGit2
+{
+
+namespace {
+    /*
+     * The index file format, all integers in network byte order:
+     *
+     *   "DIRC", quint32 version, quint32 entry count
+     *   entries, sorted by path and stage
+     *   extensions: char signature[4], quint32 size, data
+     *   SHA-1 of all of the above
+     *
+     * An entry starts with 62 bytes of stat data, id and flags, followed by
+     * 2 bytes of extended flags in version 3 when the flags say so, and the path.
+     * Up to version 3 the path is NUL terminated and padded with NULs to a multiple
+     * of 8 bytes. In version 4 it is a varint of the number of bytes to remove from
+     * the end of the previous path, followed by the NUL terminated bytes to append.
+     */
+    const quint32 HeaderSize = 12;
+    const quint32 ChecksumSize = 20;
+    const quint32 ExtensionHeaderSize = 8;
+
+    const int ModeOffset = 24;
+    const int SizeOffset = 36;
+    const int IdOffset = 40;
+    const int FlagsOffset = 60;
+    const int ExtendedFlagsOffset = 62;
+    const quint32 EntrySize = 62;
+    const quint16 ExtendedFlag = 0x4000;
+
+    /*
+     * The end of index entries extension, written last by git when
+     * index.recordEndOfIndexEntries is set: the offset of the first extension
+     * and a hash of the extension headers.
+     */
+    const char EndOfEntriesSignature[4] = { 'E', 'O', 'I', 'E' };
+    const quint32 EndOfEntriesSize = 4 + GIT_OID_RAWSZ;
+
+    /*
+     * The split index extension: the id of the shared index, then a bitmap of the
+     * shared entries that are deleted and one of those that are replaced by the
+     * first entries of this file, whose paths are left empty.
+     */
+    const char LinkSignature[4] = { 'l', 'i', 'n', 'k' };
+    const char UntrackedCacheSignature[4] = { 'U', 'N', 'T', 'R' };
+
+    /** The number of version 4 entries between two full paths kept by the view. */
+    const int CheckpointInterval = 16;
+
+    quint16 entryFlags(const uchar *entry)
+    {
+        return qFromBigEndian<quint16>(entry + FlagsOffset);
+    }
+
+    int entryStage(const uchar *entry)
+    {
+        return (entryFlags(entry) & GIT_INDEX_ENTRY_STAGEMASK) >> GIT_INDEX_ENTRY_STAGESHIFT;
+    }
+
+    void corrupt()
+    {
+        throw Exception("IndexView: corrupt index entry", Exception::Index);
+    }
+
+    struct Extension {
+        QByteArray signature;
+        quint32 offset;
+        quint32 size;
+    };
+
+    /** A mapped index file, whose entries are located as they are asked for. */
+    class IndexFile
+    {
+    public:
+        IndexFile() :
+            m_data(0),
+            m_end(0),
+            m_version(0),
+            m_count(0),
+            m_scanOffset(HeaderSize)
+        {
+        }
+
+        bool open(const QString &path)
+        {
+            m_file.setFileName(path);
+            if (!m_file.open(QIODevice::ReadOnly)) {
+                return false;
+            }
+
+            // the offsets of the entries are kept in 32 bits
+            const qint64 size = m_file.size();
+            if (size < qint64(HeaderSize + ChecksumSize) || size > qint64(0xffffffffu)) {
+                return false;
+            }
+            m_data = m_file.map(0, size);
+            if (!m_data || std::memcmp(m_data, "DIRC", 4) != 0) {
+                return false;
+            }
+            m_version = int(qFromBigEndian<quint32>(m_data + 4));
+            m_count = int(qFromBigEndian<quint32>(m_data + 8));
+            m_end = quint32(size) - ChecksumSize;
+
+            // an entry takes at least 64 bytes, whatever the version
+            return m_version >= 2 && m_version <= 4 && m_count >= 0 &&
+                   qint64(m_count) * (EntrySize + 2) <= qint64(m_end - HeaderSize);
+        }
+
+        /**
+         * Reads the path of the entry at \a offset into \a path, if not 0, and
+         * returns the offset of the next entry. In version 4, \a path must hold the
+         * previous path, and is changed in place unless it is shared.
+         */
+        quint32 decode(quint32 offset, QByteArray *path) const
+        {
+            const uchar *entry = m_data + offset;
+            quint32 pos = offset + EntrySize;
+            if (pos > m_end) {
+                corrupt();
+            }
+            if (m_version >= 3 && (entryFlags(entry) & ExtendedFlag)) {
+                pos += 2;
+            }
+
+            if (m_version < 4) {
+                const char *name = reinterpret_cast<const char*>(m_data + pos);
+                const void *nul = pos < m_end ? std::memchr(name, 0, m_end - pos) : 0;
+                if (!nul) {
+                    corrupt();
+                }
+                const quint32 length = quint32(static_cast<const char*>(nul) - name);
+                if (path) {
+                    *path = QByteArray::fromRawData(name, int(length));
+                }
+                const quint32 next = offset + ((pos - offset + length + 8) & ~7u);
+                if (next > m_end) {
+                    corrupt();
+                }
+                return next;
+            }
+
+            quint64 strip = 0;
+            uchar c;
+            do {
+                if (pos >= m_end || strip > 0xffffffffu) {
+                    corrupt();
+                }
+                c = m_data[pos++];
+                strip = (strip << 7) | (c & 0x7f);
+                if (c & 0x80) {
+                    ++strip;
+                }
+            } while (c & 0x80);
+
+            const char *suffix = reinterpret_cast<const char*>(m_data + pos);
+            const void *nul = pos < m_end ? std::memchr(suffix, 0, m_end - pos) : 0;
+            if (!nul || (path && strip > quint64(path->size()))) {
+                corrupt();
+            }
+            const int length = int(static_cast<const char*>(nul) - suffix);
+            if (path) {
+                path->truncate(path->size() - int(strip));
+                path->append(suffix, length);
+            }
+            return pos + quint32(length) + 1;
+        }
+
+        /**
+         * Reads the extension headers, from \a offset to the checksum.
+         *
+         * @return false if they do not end exactly there.
+         */
+        bool readExtensions(quint32 offset)
+        {
+            m_extensions.clear();
+            while (offset < m_end) {
+                if (m_end - offset < ExtensionHeaderSize) {
+                    return false;
+                }
+                Extension extension;
+                extension.signature = QByteArray(reinterpret_cast<const char*>(m_data + offset), 4);
+                extension.size = qFromBigEndian<quint32>(m_data + offset + 4);
+                extension.offset = offset + ExtensionHeaderSize;
+                if (extension.size > m_end - extension.offset) {
+                    return false;
+                }
+                m_extensions.append(extension);
+                offset = extension.offset + extension.size;
+            }
+            return true;
+        }
+
+        /**
+         * Finds the extensions, through the end of index entries extension if there is
+         * one, otherwise by walking over the entries.
+         */
+        bool findExtensions()
+        {
+            const quint32 eoieSize = ExtensionHeaderSize + EndOfEntriesSize;
+            if (m_end - HeaderSize >= eoieSize) {
+                const uchar *eoie = m_data + m_end - eoieSize;
+                if (std::memcmp(eoie, EndOfEntriesSignature, 4) == 0 &&
+                    qFromBigEndian<quint32>(eoie + 4) == EndOfEntriesSize) {
+                    const quint32 offset = qFromBigEndian<quint32>(eoie + ExtensionHeaderSize);
+                    if (offset >= HeaderSize && offset <= m_end - eoieSize && readExtensions(offset)) {
+                        return true;
+                    }
+                }
+            }
+
+            try {
+                quint32 offset = HeaderSize;
+                for (int i = 0; i < m_count; ++i) {
+                    offset = decode(offset, 0);
+                }
+                return readExtensions(offset);
+            } catch (const Exception &) {
+                return false;
+            }
+        }
+
+        const Extension* extension(const char signature[4]) const
+        {
+            for (int i = 0; i < m_extensions.size(); ++i) {
+                if (std::memcmp(m_extensions.at(i).signature.constData(), signature, 4) == 0) {
+                    return &m_extensions.at(i);
+                }
+            }
+            return 0;
+        }
+
+        /** Locates the entries up to \a index. */
+        void scanTo(int index) const
+        {
+            if (m_offsets.isEmpty()) {
+                m_offsets.reserve(m_count);
+            }
+            while (m_offsets.size() <= index) {
+                m_offsets.append(m_scanOffset);
+                if (m_version < 4) {
+                    m_scanOffset = decode(m_scanOffset, 0);
+                    continue;
+                }
+                m_scanOffset = decode(m_scanOffset, &m_scanPath);
+                if ((m_offsets.size() - 1) % CheckpointInterval == 0) {
+                    m_checkpoints.append(QByteArray(m_scanPath.constData(), m_scanPath.size()));
+                }
+            }
+        }
+
+        const uchar* entryData(int index) const
+        {
+            scanTo(index);
+            return m_data + m_offsets.at(index);
+        }
+
+        QByteArray pathAt(int index) const
+        {
+            scanTo(index);
+            QByteArray path;
+            if (m_version < 4) {
+                decode(m_offsets.at(index), &path);
+                return path;
+            }
+
+            const int checkpoint = index / CheckpointInterval;
+            path = m_checkpoints.at(checkpoint);
+            for (int i = checkpoint * CheckpointInterval + 1; i <= index; ++i) {
+                decode(m_offsets.at(i), &path);
+            }
+            return path;
+        }
+
+        /** Compares the entry at \a index with \a path and \a stage, in the order of the index. */
+        int compare(int index, const QByteArray &path, int stage) const
+        {
+            const QByteArray entryPath = pathAt(index);
+            if (entryPath != path) {
+                return entryPath < path ? -1 : 1;
+            }
+            return entryStage(entryData(index)) - stage;
+        }
+
+        QFile m_file;
+        const uchar *m_data;
+        quint32 m_end;
+        int m_version;
+        int m_count;
+        QVector<Extension> m_extensions;
+
+        // filled as the entries are asked for
+        mutable QVector<quint32> m_offsets;
+        mutable QVector<QByteArray> m_checkpoints;
+        mutable quint32 m_scanOffset;
+        mutable QByteArray m_scanPath;
+    };
+
+    /**
+     * A run of consecutive entries of a split index: entries of the shared index
+     * starting at \a start, or the entry of the split index at \a start.
+     */
+    struct Segment {
+        int first;
+        bool shared;
+        int start;
+    };
+}
+
+class IndexView::Private
+{
+public:
+    Private() :
+        m_extensionsFound(false),
+        m_extensionsValid(false),
+        m_split(false),
+        m_count(0)
+    {
+    }
+
+    /**
+     * Locates the extensions of the index the first time it is called, which walks
+     * over the entries when the index has no end of index entries extension.
+     *
+     * @return false if the extensions are corrupt.
+     */
+    bool findExtensions()
+    {
+        if (!m_extensionsFound) {
+            m_extensionsValid = m_index.findExtensions();
+            m_extensionsFound = true;
+        }
+        return m_extensionsValid;
+    }
+
+    /**
+     * Returns false if the index at \a path is not split: a split index can not be
+     * read without its shared index, which git writes in the same directory.
+     */
+    static bool maybeSplit(const QString &path)
+    {
+        const QFileInfo info(path);
+        return !info.dir().entryList(QStringList() << "sharedindex.*", QDir::Files).isEmpty();
+    }
+
+    bool open(const QString &path)
+    {
+        if (!m_index.open(path)) {
+            return false;
+        }
+
+        // only a split index needs its extensions to show the entries
+        if (!maybeSplit(path)) {
+            m_count = m_index.m_count;
+            return true;
+        }
+        if (!findExtensions()) {
+            return false;
+        }
+
+        const Extension *link = m_index.extension(LinkSignature);
+        if (!link) {
+            m_count = m_index.m_count;
+            return true;
+        }
+        if (link->size < GIT_OID_RAWSZ) {
+            return false;
+        }
+
+        m_sharedId = OId(reinterpret_cast<const git_oid*>(m_index.m_data + link->offset));
+        const QString sharedPath = QFileInfo(path).absolutePath() + "/sharedindex." + QString::fromLatin1(m_sharedId.format());
+        if (!m_shared.open(sharedPath)) {
+            return false;
+        }
+
+        // both bitmaps have a bit per entry of the shared index
+        const quint32 sharedCount = quint32(m_shared.m_count);
+        QVector<quint32> deleted;
+        quint32 offset = link->offset + GIT_OID_RAWSZ;
+        const quint32 end = link->offset + link->size;
+        if (offset < end) {
+            quint32 size = internal::readEwahBitmap(m_index.m_data + offset, end - offset, sharedCount, deleted);
+            if (size == 0) {
+                return false;
+            }
+            offset += size;
+            if (offset >= end || internal::readEwahBitmap(m_index.m_data + offset, end - offset, sharedCount, m_replaced) == 0) {
+                return false;
+            }
+        }
+        if ((!deleted.isEmpty() && deleted.last() >= sharedCount) ||
+            (!m_replaced.isEmpty() && m_replaced.last() >= sharedCount) ||
+            m_replaced.size() > m_index.m_count) {
+            return false;
+        }
+
+        try {
+            merge(deleted);
+        } catch (const Exception &) {
+            return false;
+        }
+        m_split = true;
+        return true;
+    }
+
+    /**
+     * Lays out the entries of the shared index that are not deleted and the entries
+     * of the split index that replace none, in the order of the index.
+     */
+    void merge(const QVector<quint32> &deleted)
+    {
+        // where the new entries go among the shared ones, found by binary searches
+        QVector<int> insertions;
+        for (int i = m_replaced.size(); i < m_index.m_count; ++i) {
+            const QByteArray path = m_index.pathAt(i);
+            const int stage = entryStage(m_index.entryData(i));
+            int lo = insertions.isEmpty() ? 0 : insertions.last();
+            int hi = m_shared.m_count;
+            while (lo < hi) {
+                const int mid = lo + (hi - lo) / 2;
+                if (m_shared.compare(mid, path, stage) < 0) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            insertions.append(lo);
+        }
+
+        int shared = 0;
+        int first = 0;
+        int d = 0;
+        int n = 0;
+        while (d < deleted.size() || n < insertions.size()) {
+            // the new entries go before a deleted entry of the same path
+            const bool insert = n < insertions.size() &&
+                                (d == deleted.size() || insertions.at(n) <= int(deleted.at(d)));
+            const int position = insert ? insertions.at(n) : int(deleted.at(d));
+            if (position > shared) {
+                const Segment segment = { first, true, shared };
+                m_segments.append(segment);
+                first += position - shared;
+                shared = position;
+            }
+            if (insert) {
+                const Segment segment = { first, false, m_replaced.size() + n };
+                m_segments.append(segment);
+                ++first;
+                ++n;
+            } else {
+                shared = position + 1;
+                ++d;
+            }
+        }
+        if (shared < m_shared.m_count) {
+            const Segment segment = { first, true, shared };
+            m_segments.append(segment);
+            first += m_shared.m_count - shared;
+        }
+        m_count = first;
+    }
+
+    /**
+     * Returns the data of the entry at \a index, and reads its path into \a path.
+     */
+    const uchar* entryAt(int index, QByteArray *path) const
+    {
+        if (!m_split) {
+            *path = m_index.pathAt(index);
+            return m_index.entryData(index);
+        }
+
+        const Segment &segment = *(std::upper_bound(m_segments.constBegin(), m_segments.constEnd(), index,
+                                                    [](int i, const Segment &s) { return i < s.first; }) - 1);
+        if (!segment.shared) {
+            *path = m_index.pathAt(segment.start);
+            return m_index.entryData(segment.start);
+        }
+
+        // a replaced entry keeps the path of the shared one
+        const int shared = segment.start + index - segment.first;
+        *path = m_shared.pathAt(shared);
+        QVector<quint32>::const_iterator replaced = std::lower_bound(m_replaced.constBegin(), m_replaced.constEnd(), quint32(shared));
+        if (replaced != m_replaced.constEnd() && int(*replaced) == shared) {
+            return m_index.entryData(int(replaced - m_replaced.constBegin()));
+        }
+        return m_shared.entryData(shared);
+    }
+
+    IndexFile m_index;
+    bool m_extensionsFound;
+    bool m_extensionsValid;
+
+    // for a split index
+    bool m_split;
+    OId m_sharedId;
+    IndexFile m_shared;
+    QVector<quint32> m_replaced;
+    QVector<Segment> m_segments;
+
+    int m_count;
+};
+
+
+IndexView::Entry::Entry() :
+    m_data(0)
+{
+}
+
+IndexView::Entry::Entry(const QSharedPointer<const Private> &d, const uchar *data, const QByteArray &path) :
+    d_ptr(d),
+    m_data(data),
+    m_path(path)
+{
+}
+
+QString IndexView::Entry::path() const
+{
+    return PathCodec::fromLibGit2(m_path);
+}
+
+OId IndexView::Entry::id() const
+{
+    return m_data ? OId(reinterpret_cast<const git_oid*>(m_data + IdOffset)) : OId();
+}
+
+quint32 IndexView::Entry::mode() const
+{
+    return m_data ? qFromBigEndian<quint32>(m_data + ModeOffset) : 0;
+}
+
+quint32 IndexView::Entry::fileSize() const
+{
+    return m_data ? qFromBigEndian<quint32>(m_data + SizeOffset) : 0;
+}
+
+int IndexView::Entry::stage() const
+{
+    return m_data ? entryStage(m_data) : 0;
+}
+
+quint16 IndexView::Entry::flags() const
+{
+    return m_data ? entryFlags(m_data) : 0;
+}
+
+quint16 IndexView::Entry::extendedFlags() const
+{
+    return (flags() & ExtendedFlag) ? qFromBigEndian<quint16>(m_data + ExtendedFlagsOffset) : 0;
+}
+
+
+IndexView::Cursor::Cursor(const IndexView &view) :
+    d_ptr(view.d_ptr),
+    m_position(-1),
+    m_offset(HeaderSize)
+{
+    // big enough for most paths, so that version 4 paths are rebuilt in place
+    m_path.reserve(256);
+}
+
+bool IndexView::Cursor::next()
+{
+    if (m_position + 1 >= d_ptr->m_count) {
+        m_entry = Entry();
+        return false;
+    }
+
+    ++m_position;
+    if (d_ptr->m_split) {
+        QByteArray path;
+        const uchar *data = d_ptr->entryAt(m_position, &path);
+        m_entry = Entry(d_ptr, data, path);
+        return true;
+    }
+
+    const IndexFile &index = d_ptr->m_index;
+    const quint32 offset = m_offset;
+    if (index.m_version < 4) {
+        QByteArray path;
+        m_offset = index.decode(offset, &path);
+        m_entry = Entry(d_ptr, index.m_data + offset, path);
+    } else {
+        // the path is rebuilt in place unless a copy of the previous entry still shares it
+        m_entry = Entry();
+        m_offset = index.decode(offset, &m_path);
+        m_entry = Entry(d_ptr, index.m_data + offset, m_path);
+    }
+    return true;
+}
+
+
+IndexView::IndexView() :
+    d_ptr(new Private)
+{
+}
+
+IndexView::~IndexView()
+{
+}
+
+QString IndexView::defaultPath(const Repository &repository)
+{
+    return repository.path() + "index";
+}
+
+bool IndexView::open(const QString &path)
+{
+    // copies of the view keep the file they have
+    d_ptr = QSharedPointer<Private>(new Private);
+    if (!d_ptr->open(path)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void IndexView::close()
+{
+    d_ptr = QSharedPointer<Private>(new Private);
+}
+
+bool IndexView::isOpen() const
+{
+    return d_ptr->m_index.m_data != 0;
+}
+
+int IndexView::version() const
+{
+    return d_ptr->m_index.m_version;
+}
+
+int IndexView::count() const
+{
+    return d_ptr->m_count;
+}
+
+IndexView::Entry IndexView::entry(int index) const
+{
+    if (index < 0 || index >= d_ptr->m_count) {
+        return Entry();
+    }
+    QByteArray path;
+    const uchar *data = d_ptr->entryAt(index, &path);
+    return Entry(d_ptr, data, path);
+}
+
+int IndexView::find(const QByteArray &rawPath, int stage) const
+{
+    // the entries are sorted by path, then by stage
+    int lo = 0;
+    int hi = d_ptr->m_count;
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+        QByteArray midPath;
+        const uchar *midData = d_ptr->entryAt(mid, &midPath);
+        int cmp = midPath != rawPath ? (midPath < rawPath ? -1 : 1) : entryStage(midData) - stage;
+        if (cmp == 0) {
+            return mid;
+        } else if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return -1;
+}
+
+IndexView::Cursor IndexView::cursor() const
+{
+    return Cursor(*this);
+}
+
+QList<QByteArray> IndexView::extensions() const
+{
+    QList<QByteArray> result;
+    if (!isOpen() || !d_ptr->findExtensions()) {
+        return result;
+    }
+    foreach (const Extension &extension, d_ptr->m_index.m_extensions) {
+        result.append(extension.signature);
+    }
+    return result;
+}
+
+bool IndexView::hasUntrackedCache() const
+{
+    return isOpen() && d_ptr->findExtensions() && d_ptr->m_index.extension(UntrackedCacheSignature) != 0;
+}
+
+bool IndexView::isSplit() const
+{
+    return d_ptr->m_split;
+}
+
+OId IndexView::sharedIndexId() const
+{
+    return d_ptr->m_sharedId;
+}
+
+} // namespace LibQGit2
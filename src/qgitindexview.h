@@ -0,0 +1,253 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_INDEXVIEW_H
+#define LIBQGIT2_INDEXVIEW_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+
+#include "git2.h"
+
+#include "libqgit2_export.h"
+#include "qgitoid.h"
+
+namespace LibQGit2
+{
+
+class Repository;
+
+/**
+ * @brief A read-only view of an index file that decodes the entries on demand.
+ *
+ * The file is memory-mapped and only its header is read when it is opened, so
+ * opening an index of millions of entries takes no time and memory. The entries
+ * are located the first time they are asked for, and their paths are returned as
+ * raw bytes pointing into the mapped file where the format allows it. Versions 2,
+ * 3 and 4 of the index format are supported; with version 4, where every path is
+ * stored relative to the previous one, a path is rebuilt from the nearest of the
+ * full paths kept every few entries.
+ *
+ * Walk the entries with a Cursor to read them all; it decodes every path once.
+ *
+ * A split index, as written by git with core.splitIndex, is read together with
+ * the shared index it refers to, and the view shows the entries of both merged.
+ * The extensions are located the first time they are asked for: at once if git
+ * recorded where the entries end (index.recordEndOfIndexEntries), otherwise by
+ * walking over the entries. Only when a sharedindex.<id> file lies next to the
+ * index are they located on open, to find out whether the index is split.
+ *
+ * The view does not see the changes made to the index afterwards, and is not
+ * thread-safe: copies share their data, including the lazily built lookup tables.
+ *
+ * @ingroup LibQGit2
+ * @{
+ */
+class LIBQGIT2_EXPORT IndexView
+{
+    class Private;
+
+public:
+    /**
+     * @brief An entry of an IndexView.
+     *
+     * An entry keeps the mapped index file it was read from, so it stays valid
+     * after the view is closed, opened again or destroyed.
+     */
+    class LIBQGIT2_EXPORT Entry
+    {
+    public:
+        Entry();
+
+        bool isValid() const { return m_data != 0; }
+
+        /**
+         * Returns the path of the entry as stored in the index. The bytes may point
+         * into the mapped index file.
+         */
+        QByteArray rawPath() const { return m_path; }
+
+        /**
+         * Returns the path of the entry, converted from rawPath().
+         */
+        QString path() const;
+
+        OId id() const;
+
+        /**
+         * Returns the file mode of the entry, a git_filemode_t value.
+         */
+        quint32 mode() const;
+
+        /**
+         * Returns the size of the file in the working directory, truncated to 32 bits.
+         */
+        quint32 fileSize() const;
+
+        /**
+         * Returns the merge stage of the entry; 0 when it is not conflicted.
+         */
+        int stage() const;
+
+        /**
+         * Returns the flags of the entry as in git_index_entry::flags.
+         */
+        quint16 flags() const;
+
+        /**
+         * Returns the extended flags of the entry as in git_index_entry::flags_extended.
+         */
+        quint16 extendedFlags() const;
+
+    private:
+        Entry(const QSharedPointer<const Private> &d, const uchar *data, const QByteArray &path);
+
+        QSharedPointer<const Private> d_ptr;
+        const uchar *m_data;
+        QByteArray m_path;
+
+        friend class IndexView;
+    };
+
+    /**
+     * @brief Reads the entries of an IndexView one after the other.
+     */
+    class LIBQGIT2_EXPORT Cursor
+    {
+    public:
+        /**
+         * Moves to the next entry, the first one after the cursor was made.
+         *
+         * @return false at the end of the entries.
+         * @throws LibQGit2::Exception if the entry is corrupt.
+         */
+        bool next();
+
+        /**
+         * Returns the position of the current entry.
+         */
+        int position() const { return m_position; }
+
+        /**
+         * Returns the current entry.
+         */
+        const Entry& entry() const { return m_entry; }
+
+    private:
+        explicit Cursor(const IndexView &view);
+
+        QSharedPointer<const Private> d_ptr;
+        int m_position;
+        quint32 m_offset;
+        QByteArray m_path;
+        Entry m_entry;
+
+        friend class IndexView;
+    };
+
+    /**
+     * Creates a closed view.
+     */
+    IndexView();
+
+    ~IndexView();
+
+    /**
+     * The path of the index file of \a repository.
+     */
+    static QString defaultPath(const Repository &repository);
+
+    /**
+     * Maps the index file at \a path.
+     *
+     * @return false if the file can not be read, is not an index file of a
+     * supported version, or is a split index whose shared index can not be read;
+     * the view is then closed.
+     */
+    bool open(const QString &path);
+
+    void close();
+
+    bool isOpen() const;
+
+    /**
+     * Returns the version of the index format, 2, 3 or 4.
+     */
+    int version() const;
+
+    /**
+     * Returns the number of entries.
+     */
+    int count() const;
+
+    /**
+     * Returns the entry at \a index. For a version 4 index the path is a copy.
+     *
+     * @param index an index from the interval 0 <= index < count().
+     * @throws LibQGit2::Exception if the index file is corrupt.
+     */
+    Entry entry(int index) const;
+
+    /**
+     * Finds the entry of \a rawPath at \a stage, by a binary search over the entries.
+     *
+     * @return the index of the entry, or -1 if there is none.
+     * @throws LibQGit2::Exception if the index file is corrupt.
+     */
+    int find(const QByteArray &rawPath, int stage = 0) const;
+
+    /**
+     * Returns a cursor before the first entry.
+     */
+    Cursor cursor() const;
+
+    /**
+     * Returns the signatures of the extensions of the index file, in file order,
+     * e.g. "TREE" for the cached trees, or an empty list if they are corrupt.
+     * The first call may walk over the entries, see the class documentation.
+     */
+    QList<QByteArray> extensions() const;
+
+    /**
+     * Returns true if the index has an untracked cache, the "UNTR" extension git
+     * keeps with core.untrackedCache to skip unchanged directories when looking for
+     * untracked files.
+     */
+    bool hasUntrackedCache() const;
+
+    /**
+     * Returns true if the index is split: its entries are the changes to a shared
+     * index file, sharedindex.<id> in the same directory.
+     */
+    bool isSplit() const;
+
+    /**
+     * Returns the id of the shared index of a split index, or an invalid OId.
+     */
+    OId sharedIndexId() const;
+
+private:
+    QSharedPointer<Private> d_ptr;
+};
+
+/**@}*/
+}
+
+#endif // LIBQGIT2_INDEXVIEW_H
@@ -182,6 +182,7 @@ namespace LibQGit2
 
             static Type resolveType(git_otype);
 
+            friend class Repository;
             friend class TreeEntry;
     };
 
@@ -21,39 +21,31 @@
 #include "qgitoid.h"
 #include "qgitexception.h"
 
+#include <cstring>
+
 namespace LibQGit2
 {
 
 OId::OId(const git_oid* oid)
-    : d(GIT_OID_RAWSZ, 0)
+    : m_length(GIT_OID_HEXSZ)
 {
     if (oid != 0) {
-        git_oid_cpy(data(), oid);
+        git_oid_cpy(&d, oid);
+    } else {
+        std::memset(d.id, 0, GIT_OID_RAWSZ);
     }
 }
 
-OId::OId(const OId& other)
-    : d(other.d)
-{
-}
-
-OId::~OId()
-{
-}
-
 bool OId::isValid() const
 {
-    return ( !d.isEmpty() &&
-             (d.length() <= GIT_OID_RAWSZ) &&
-             (d != QByteArray(GIT_OID_RAWSZ, 0))
-             );
+    return m_length > 0 && !git_oid_iszero(&d);
 }
 
 void OId::fromHex(const QByteArray& hex)
 {
     int len = qMin(hex.length(), GIT_OID_HEXSZ);
-    qGitThrow(git_oid_fromstrn(data(), hex.constData(), len));
-    d.resize(len / 2);
+    qGitThrow(git_oid_fromstrn(&d, hex.constData(), len));
+    m_length = len;
 }
 
 void OId::fromString(const QString& string)
@@ -64,23 +56,23 @@ void OId::fromString(const QString& string)
 
 void OId::fromRawData(const QByteArray& raw)
 {
-    qGitThrow(raw.length() < GIT_OID_HEXSZ);
-    d = raw;
+    int len = qMin(raw.length(), GIT_OID_RAWSZ);
+    std::memset(d.id, 0, GIT_OID_RAWSZ);
+    std::memcpy(d.id, raw.constData(), len);
+    m_length = len * 2;
 }
 
 OId OId::stringToOid(const QByteArray& string)
 {
-    int len = qMin(string.length(), GIT_OID_HEXSZ);
     OId oid;
-    qGitThrow(git_oid_fromstrn(oid.data(), string.constData(), len));
-    oid.d.resize(len / 2);
+    oid.fromHex(string);
     return oid;
 }
 
 OId OId::rawDataToOid(const QByteArray& raw)
 {
     OId oid;
-    oid.d = raw;
+    oid.fromRawData(raw);
     return oid;
 }
 
@@ -98,19 +90,9 @@ QByteArray OId::pathFormat() const
     return ba;
 }
 
-git_oid* OId::data()
-{
-    return reinterpret_cast<git_oid*>(d.data());
-}
-
-const git_oid* OId::constData() const
-{
-    return reinterpret_cast<const git_oid*>(d.constData());
-}
-
 bool operator ==(const OId &oid1, const OId &oid2)
 {
-    return git_oid_cmp(oid1.constData(), oid2.constData()) == 0;
+    return git_oid_equal(oid1.constData(), oid2.constData());
 }
 
 bool operator !=(const OId &oid1, const OId &oid2)
@@ -118,9 +100,9 @@ bool operator !=(const OId &oid1, const OId &oid2)
     return !(operator ==(oid1, oid2));
 }
 
-int OId::length() const
+bool operator <(const OId &oid1, const OId &oid2)
 {
-    return d.length() * 2;
+    return git_oid_cmp(oid1.constData(), oid2.constData()) < 0;
 }
 
 } // LibQGit2
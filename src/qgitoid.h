@@ -24,6 +24,9 @@
 #include <QtCore/QString>
 #include <QtCore/QDateTime>
 
+#include <cstring>
+#include <functional>
+
 #include "git2.h"
 
 #include "libqgit2_export.h"
@@ -34,14 +37,13 @@ namespace LibQGit2
      * @brief Wrapper class for git_oid.
      *
      * This class holds a Git SHA1 object id, i.e. 40 hexadecimal digits.
-     * Instead of using the git_oid structure, which is an unsigned char array,
-     * the object redefines it as a QByteArray and provides the conversion
-     * to git_oid through data() and constData().
+     * The git_oid structure is stored inline, so copying, comparing and
+     * hashing an OId never allocates; data() and constData() give access to
+     * it for the libgit2 functions.
      *
-     * Remember that the QByteArray stores 2 hexadecimal digits for each
-     * element, so the length of the array is half that of the SHA1, namely 20 bytes.
-     * This can either encompass a full oid (40 hexadecimal digits) or a part of it,
-     * (short reference).
+     * An OId can either hold a full oid (40 hexadecimal digits) or a part of
+     * it (short reference), in which case length() is less than 40 and the
+     * unused bytes of the git_oid are zero.
      *
      * @ingroup LibQGit2
      * @{
@@ -55,15 +57,10 @@ namespace LibQGit2
              */
             explicit OId(const git_oid *oid = 0);
 
-            /**
-             * Copy constructor
-             */
-            OId(const OId& other);
-
-            /**
-             * Destructor
-             */
-            ~OId();
+            OId(const OId& other) Q_DECL_NOTHROW = default;
+            OId(OId&& other) Q_DECL_NOTHROW = default;
+            OId& operator=(const OId& other) Q_DECL_NOTHROW = default;
+            OId& operator=(OId&& other) Q_DECL_NOTHROW = default;
 
             /**
              * Set the value of the object parsing a hex array.
@@ -99,9 +96,9 @@ namespace LibQGit2
             /**
              * Set the value of the object from a raw oid.
              *
-             * This method uses the input raw hexadecimal array without parsing
-             * it and without performing prefix lookup. The raw array must be
-             * 40 characters long, otherwise throws Exception.
+             * This method uses the input raw bytes without parsing them and
+             * without performing prefix lookup. At most 20 bytes are used; a
+             * shorter array gives a shortened OId.
              *
              * @param raw the raw input bytes to be copied.
              * @throws Exception
@@ -128,6 +125,7 @@ namespace LibQGit2
 
             /**
               Checks if this is a valid Git OId. An OId is invalid if it is empty or 0x0000... (20 byte).
+              This does not allocate.
               @return True, if the OId is valid. False if not.
               */
             bool isValid() const;
@@ -145,8 +143,8 @@ namespace LibQGit2
              */
             QByteArray pathFormat() const;
 
-            git_oid* data();
-            const git_oid* constData() const;
+            git_oid* data() { return &d; }
+            const git_oid* constData() const { return &d; }
 
             /**
              * Returns the length of the OId as a number of hexadecimal
@@ -155,10 +153,16 @@ namespace LibQGit2
              * The full length of a OId is 40, but the OId represented by this
              * class may be shorter.
              */
-            int length() const;
+            int length() const { return m_length; }
+
+            /**
+             * Returns true if this OId holds all the 40 hexadecimal digits.
+             */
+            bool isFull() const { return m_length == GIT_OID_HEXSZ; }
 
         private:
-            QByteArray d;
+            git_oid d;
+            int m_length;
     };
 
     /**
@@ -169,8 +173,36 @@ namespace LibQGit2
      * Compare two OIds.
      */
     LIBQGIT2_EXPORT bool operator !=(const OId &oid1, const OId &oid2);
+    /**
+     * Orders OIds by their raw bytes, as git does.
+     */
+    LIBQGIT2_EXPORT bool operator <(const OId &oid1, const OId &oid2);
+
+    /**
+     * Hashes the leading bytes of the SHA1, which are already uniformly distributed.
+     */
+    inline uint qHash(const OId &oid, uint seed = 0) Q_DECL_NOTHROW
+    {
+        uint h;
+        std::memcpy(&h, oid.constData()->id, sizeof(h));
+        return h ^ seed;
+    }
 
     /**@}*/
 }
 
+namespace std
+{
+    template <>
+    struct hash<LibQGit2::OId>
+    {
+        size_t operator()(const LibQGit2::OId &oid) const Q_DECL_NOTHROW
+        {
+            size_t h;
+            std::memcpy(&h, oid.constData()->id, sizeof(h));
+            return h;
+        }
+    };
+}
+
 #endif // LIBQGIT2_OID_H
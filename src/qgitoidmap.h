@@ -0,0 +1,315 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_OIDMAP_H
+#define LIBQGIT2_OIDMAP_H
+
+#include <QtCore/QVector>
+#include <QtCore/QtEndian>
+#include <QtCore/qalgorithms.h>
+
+#include <cstring>
+#include <utility>
+
+#include "qgitoid.h"
+
+namespace LibQGit2
+{
+    namespace internal
+    {
+        /*
+         * Every slot of an OIdMap has a control byte: the 7 low bits of the hash
+         * of its key when it is used, otherwise one of the values below. The
+         * control bytes of a group of slots are tested all at once as a 64 bit word.
+         */
+        const quint8 OIdSlotEmpty = 0x80;
+        const quint8 OIdSlotDeleted = 0xfe;
+        const int OIdGroupSize = 8;
+
+        const quint64 OIdGroupLsb = Q_UINT64_C(0x0101010101010101);
+        const quint64 OIdGroupMsb = Q_UINT64_C(0x8080808080808080);
+
+        inline quint64 oidMapHash(const git_oid *oid)
+        {
+            quint64 hash;
+            std::memcpy(&hash, oid->id, sizeof(hash));
+            return hash;
+        }
+
+        /** Marks the bytes of \a group equal to \a tag, with rare false positives. */
+        inline quint64 oidGroupMatch(quint64 group, quint8 tag)
+        {
+            const quint64 x = group ^ (OIdGroupLsb * tag);
+            return (x - OIdGroupLsb) & ~x & OIdGroupMsb;
+        }
+
+        inline quint64 oidGroupMatchEmpty(quint64 group)
+        {
+            return group & ~(group << 6) & OIdGroupMsb;
+        }
+
+        inline quint64 oidGroupMatchFree(quint64 group)
+        {
+            return group & OIdGroupMsb;
+        }
+    }
+
+    /**
+     * @brief A hash map from object ids to values.
+     *
+     * The map uses open addressing over flat arrays: the keys, the values and
+     * one control byte per slot are each stored contiguously, so that a lookup
+     * tests the control bytes of eight slots at once and then compares a
+     * single key in most cases. The keys are hashed by their leading bytes.
+     *
+     * Prefer it over QHash<OId, T> for large sets of objects. OIdMap is
+     * implicitly shared. \a T must be default-constructible.
+     *
+     * @ingroup LibQGit2
+     * @{
+     */
+    template <typename T>
+    class OIdMap
+    {
+        public:
+            OIdMap() : m_size(0), m_growthLeft(0) {}
+
+            /**
+             * Returns the number of entries in the map.
+             */
+            int size() const { return m_size; }
+
+            bool isEmpty() const { return m_size == 0; }
+
+            /**
+             * Returns the number of slots in the map.
+             */
+            int capacity() const { return m_ctrl.size(); }
+
+            /**
+             * Removes all the entries and frees the memory.
+             */
+            void clear()
+            {
+                m_ctrl.clear();
+                m_keys.clear();
+                m_values.clear();
+                m_size = 0;
+                m_growthLeft = 0;
+            }
+
+            /**
+             * Makes room for \a count entries without further allocations.
+             */
+            void reserve(int count)
+            {
+                int capacity = MinCapacity;
+                while (capacity / 8 * 7 < count) {
+                    capacity *= 2;
+                }
+                if (capacity > m_ctrl.size()) {
+                    rehash(capacity);
+                }
+            }
+
+            bool contains(const OId& oid) const
+            {
+                return findSlot(oid.constData()) >= 0;
+            }
+
+            /**
+             * Returns a pointer to the value of \a oid, or 0 if it is not in the map.
+             * The pointer is valid until the map is modified.
+             */
+            const T* find(const OId& oid) const
+            {
+                int slot = findSlot(oid.constData());
+                return slot >= 0 ? m_values.constData() + slot : 0;
+            }
+
+            T* find(const OId& oid)
+            {
+                int slot = findSlot(oid.constData());
+                return slot >= 0 ? m_values.data() + slot : 0;
+            }
+
+            T value(const OId& oid, const T& defaultValue = T()) const
+            {
+                const T *v = find(oid);
+                return v ? *v : defaultValue;
+            }
+
+            /**
+             * Returns the value of \a oid, inserting a default-constructed one if
+             * it is not in the map.
+             */
+            T& operator[](const OId& oid)
+            {
+                bool inserted;
+                return m_values[insertSlot(oid.constData(), inserted)];
+            }
+
+            /**
+             * Sets the value of \a oid.
+             *
+             * @return true if \a oid was not in the map before.
+             */
+            bool insert(const OId& oid, const T& value)
+            {
+                bool inserted;
+                m_values[insertSlot(oid.constData(), inserted)] = value;
+                return inserted;
+            }
+
+            /**
+             * Removes \a oid from the map.
+             *
+             * @return true if \a oid was in the map.
+             */
+            bool remove(const OId& oid)
+            {
+                int slot = findSlot(oid.constData());
+                if (slot < 0) {
+                    return false;
+                }
+                m_ctrl[slot] = internal::OIdSlotDeleted;
+                m_values[slot] = T();
+                --m_size;
+                return true;
+            }
+
+            /**
+             * Calls \a f(const OId&, const T&) for every entry, in no particular order.
+             */
+            template <typename F>
+            void forEach(F f) const
+            {
+                const quint8 *ctrl = m_ctrl.constData();
+                for (int i = 0; i < m_ctrl.size(); ++i) {
+                    if (ctrl[i] < internal::OIdSlotEmpty) {
+                        f(OId(m_keys.constData() + i), m_values.at(i));
+                    }
+                }
+            }
+
+        private:
+            enum { MinCapacity = 2 * internal::OIdGroupSize };
+
+            quint64 group(int g) const
+            {
+                return qFromLittleEndian<quint64>(m_ctrl.constData() + g * internal::OIdGroupSize);
+            }
+
+            int findSlot(const git_oid *key) const
+            {
+                if (m_ctrl.isEmpty()) {
+                    return -1;
+                }
+
+                const quint64 hash = internal::oidMapHash(key);
+                const quint8 tag = quint8(hash & 0x7f);
+                const int mask = m_ctrl.size() / internal::OIdGroupSize - 1;
+                int g = int((hash >> 7) & quint64(mask));
+                for (int step = 1; ; ++step) {
+                    const quint64 word = group(g);
+                    for (quint64 m = internal::oidGroupMatch(word, tag); m; m &= m - 1) {
+                        int slot = g * internal::OIdGroupSize + qCountTrailingZeroBits(m) / 8;
+                        if (git_oid_equal(m_keys.constData() + slot, key)) {
+                            return slot;
+                        }
+                    }
+                    if (internal::oidGroupMatchEmpty(word)) {
+                        return -1;
+                    }
+                    g = (g + step) & mask;
+                }
+            }
+
+            /** Returns the first free slot on the probe sequence of \a hash. */
+            int freeSlot(quint64 hash) const
+            {
+                const int mask = m_ctrl.size() / internal::OIdGroupSize - 1;
+                int g = int((hash >> 7) & quint64(mask));
+                for (int step = 1; ; ++step) {
+                    quint64 m = internal::oidGroupMatchFree(group(g));
+                    if (m) {
+                        return g * internal::OIdGroupSize + qCountTrailingZeroBits(m) / 8;
+                    }
+                    g = (g + step) & mask;
+                }
+            }
+
+            int insertSlot(const git_oid *key, bool &inserted)
+            {
+                int slot = findSlot(key);
+                if (slot >= 0) {
+                    inserted = false;
+                    return slot;
+                }
+
+                if (m_growthLeft == 0) {
+                    // only grow when the slots are really used, not just deleted
+                    const int capacity = m_ctrl.size();
+                    rehash(capacity == 0 ? int(MinCapacity) :
+                           m_size >= capacity / 16 * 7 ? capacity * 2 : capacity);
+                }
+
+                const quint64 hash = internal::oidMapHash(key);
+                slot = freeSlot(hash);
+                if (m_ctrl.at(slot) == internal::OIdSlotEmpty) {
+                    --m_growthLeft;
+                }
+                m_ctrl[slot] = quint8(hash & 0x7f);
+                git_oid_cpy(m_keys.data() + slot, key);
+                ++m_size;
+                inserted = true;
+                return slot;
+            }
+
+            void rehash(int capacity)
+            {
+                QVector<quint8> ctrl(m_ctrl);
+                QVector<git_oid> keys(m_keys);
+                QVector<T> values(m_values);
+
+                m_ctrl = QVector<quint8>(capacity, internal::OIdSlotEmpty);
+                m_keys = QVector<git_oid>(capacity);
+                m_values = QVector<T>(capacity);
+                m_growthLeft = capacity / 8 * 7 - m_size;
+
+                for (int i = 0; i < ctrl.size(); ++i) {
+                    if (ctrl.at(i) < internal::OIdSlotEmpty) {
+                        int slot = freeSlot(internal::oidMapHash(keys.constData() + i));
+                        m_ctrl[slot] = ctrl.at(i);
+                        git_oid_cpy(m_keys.data() + slot, keys.constData() + i);
+                        m_values[slot] = std::move(values[i]);
+                    }
+                }
+            }
+
+            QVector<quint8> m_ctrl;
+            QVector<git_oid> m_keys;
+            QVector<T> m_values;
+            int m_size;
+            int m_growthLeft;
+    };
+
+    /**@}*/
+}
+
+#endif // LIBQGIT2_OIDMAP_H
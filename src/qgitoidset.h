@@ -0,0 +1,98 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_OIDSET_H
+#define LIBQGIT2_OIDSET_H
+
+#include <QtCore/QVector>
+
+#include "qgitoidmap.h"
+
+namespace LibQGit2
+{
+    namespace internal
+    {
+        struct OIdSetValue {};
+    }
+
+    /**
+     * @brief A hash set of object ids.
+     *
+     * Uses the same flat open-addressing table as OIdMap; insert() tells whether
+     * the id was new, which is all a deduplication pass needs.
+     *
+     * @ingroup LibQGit2
+     * @{
+     */
+    class OIdSet
+    {
+        public:
+            int size() const { return m_map.size(); }
+            bool isEmpty() const { return m_map.isEmpty(); }
+            int capacity() const { return m_map.capacity(); }
+            void clear() { m_map.clear(); }
+
+            /**
+             * Makes room for \a count ids without further allocations.
+             */
+            void reserve(int count) { m_map.reserve(count); }
+
+            bool contains(const OId& oid) const { return m_map.contains(oid); }
+
+            /**
+             * Adds \a oid to the set.
+             *
+             * @return true if \a oid was not in the set before.
+             */
+            bool insert(const OId& oid) { return m_map.insert(oid, internal::OIdSetValue()); }
+
+            /**
+             * Removes \a oid from the set.
+             *
+             * @return true if \a oid was in the set.
+             */
+            bool remove(const OId& oid) { return m_map.remove(oid); }
+
+            /**
+             * Calls \a f(const OId&) for every id, in no particular order.
+             */
+            template <typename F>
+            void forEach(F f) const
+            {
+                m_map.forEach([&f](const OId& oid, const internal::OIdSetValue&) { f(oid); });
+            }
+
+            /**
+             * Returns the ids of the set, in no particular order.
+             */
+            QVector<OId> values() const
+            {
+                QVector<OId> result;
+                result.reserve(size());
+                forEach([&result](const OId& oid) { result.append(oid); });
+                return result;
+            }
+
+        private:
+            OIdMap<internal::OIdSetValue> m_map;
+    };
+
+    /**@}*/
+}
+
+#endif // LIBQGIT2_OIDSET_H
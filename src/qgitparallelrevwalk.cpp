@@ -0,0 +1,201 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitparallelrevwalk.h"
+
+#include <algorithm>
+#include <queue>
+
+#include "qgitcommitbatch.h"
+#include "qgitref.h"
+#include "qgitrepository.h"
+#include "private/workerpool.h"
+
+namespace LibQGit2
+{
+
+namespace {
+    const int BatchSize = 1024;
+
+    struct Range {
+        QVector<OId> oids;
+        QVector<qint64> times;
+    };
+
+    struct RangeHead {
+        qint64 time;
+        int range;
+        int pos;
+
+        bool operator<(const RangeHead &other) const
+        {
+            // std::priority_queue pops the greatest element: the newest commit,
+            // and on equal times the one from the most recently pushed range
+            if (time != other.time) {
+                return time < other.time;
+            }
+            return range < other.range;
+        }
+    };
+}
+
+class ParallelRevWalk::Private
+{
+public:
+    Private(const Repository &repository, int threadCount) :
+        m_repository(&repository),
+        m_pool(repository.path(), threadCount),
+        m_sorting(RevWalk::None)
+    {
+    }
+
+    void walkRange(internal::WorkerPool::Worker &worker, int i, Range &range) const
+    {
+        RevWalk rw(worker.repository);
+        rw.setSorting(RevWalk::SortModes(int(m_sorting) & ~int(RevWalk::Reverse)));
+        rw.push(m_tips[i]);
+        for (int j = 0; j < i; ++j) {
+            rw.hide(m_tips[j]);
+        }
+        foreach (const OId &oid, m_hidden) {
+            rw.hide(oid);
+        }
+
+        if (mergeByTime()) {
+            CommitBatch batch;
+            while (rw.nextBatch(batch, BatchSize)) {
+                for (int k = 0; k < batch.count(); ++k) {
+                    range.oids.append(batch.oid(k));
+                    range.times.append(batch.at(k).time);
+                }
+            }
+        } else {
+            OId oid;
+            while (rw.next(oid)) {
+                range.oids.append(oid);
+            }
+        }
+    }
+
+    bool mergeByTime() const
+    {
+        return m_sorting.testFlag(RevWalk::Time) && !m_sorting.testFlag(RevWalk::Topological);
+    }
+
+    QVector<OId> walk()
+    {
+        QVector<Range> ranges(m_tips.size());
+        Range *rangeData = ranges.data();
+        m_pool.run(m_tips.size(), [this, rangeData](internal::WorkerPool::Worker &worker, int i) {
+            walkRange(worker, i, rangeData[i]);
+        });
+
+        int total = 0;
+        foreach (const Range &range, ranges) {
+            total += range.oids.size();
+        }
+
+        QVector<OId> result;
+        result.reserve(total);
+
+        if (mergeByTime()) {
+            std::priority_queue<RangeHead> heads;
+            for (int i = 0; i < ranges.size(); ++i) {
+                if (!ranges[i].oids.isEmpty()) {
+                    RangeHead head = { ranges[i].times[0], i, 0 };
+                    heads.push(head);
+                }
+            }
+            while (!heads.empty()) {
+                RangeHead head = heads.top();
+                heads.pop();
+                const Range &range = ranges[head.range];
+                result.append(range.oids[head.pos]);
+                if (++head.pos < range.oids.size()) {
+                    head.time = range.times[head.pos];
+                    heads.push(head);
+                }
+            }
+        } else {
+            // a range only contains ancestors of the ranges pushed after it
+            for (int i = ranges.size() - 1; i >= 0; --i) {
+                result += ranges[i].oids;
+            }
+        }
+
+        if (m_sorting.testFlag(RevWalk::Reverse)) {
+            std::reverse(result.begin(), result.end());
+        }
+
+        return result;
+    }
+
+    const Repository *m_repository;
+    internal::WorkerPool m_pool;
+    QVector<OId> m_tips;
+    QVector<OId> m_hidden;
+    RevWalk::SortModes m_sorting;
+};
+
+
+ParallelRevWalk::ParallelRevWalk(const Repository& repository, int threadCount)
+    : d_ptr(new Private(repository, threadCount))
+{
+}
+
+ParallelRevWalk::~ParallelRevWalk()
+{
+}
+
+void ParallelRevWalk::reset()
+{
+    d_ptr->m_tips.clear();
+    d_ptr->m_hidden.clear();
+}
+
+void ParallelRevWalk::push(const OId& oid)
+{
+    d_ptr->m_tips.append(oid);
+}
+
+void ParallelRevWalk::push(const Reference& reference)
+{
+    push(reference.resolve().target());
+}
+
+void ParallelRevWalk::pushHead()
+{
+    push(d_ptr->m_repository->head().target());
+}
+
+void ParallelRevWalk::hide(const OId& oid)
+{
+    d_ptr->m_hidden.append(oid);
+}
+
+void ParallelRevWalk::setSorting(RevWalk::SortModes sortMode)
+{
+    d_ptr->m_sorting = sortMode;
+}
+
+QVector<OId> ParallelRevWalk::walk() const
+{
+    return d_ptr->walk();
+}
+
+} // namespace LibQGit2
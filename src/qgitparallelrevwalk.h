@@ -0,0 +1,131 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_PARALLELREVWALK_H
+#define LIBQGIT2_PARALLELREVWALK_H
+
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
+
+#include "qgitrevwalk.h"
+#include "qgitoid.h"
+
+#include "libqgit2_export.h"
+
+namespace LibQGit2
+{
+
+class Repository;
+class Reference;
+
+/**
+  * @brief A revision walker that splits the traversal over several threads.
+  *
+  * Every pushed tip defines one range of the walk: the commits reachable from
+  * that tip, minus the commits reachable from the tips pushed before it and
+  * from the hidden commits. The ranges are disjoint, so they are walked
+  * independently, each one by a worker thread that has its own handle on the
+  * repository.
+  *
+  * The walk is only parallel across ranges: the history of a single pushed tip
+  * is not split automatically, so walking it from one tip, e.g. after only
+  * pushHead(), uses one thread and is no faster than a RevWalk. To split the
+  * history of a single branch, push some of its older commits (e.g. release
+  * tags) first, oldest first, and the branch tip last.
+  *
+  * @ingroup LibQGit2
+  * @{
+  */
+class LIBQGIT2_EXPORT ParallelRevWalk
+{
+public:
+    /**
+     * Creates a walker on \a repository.
+     *
+     * @param repository the repository to walk through
+     * @param threadCount the number of worker threads; the ideal thread count of
+     * the machine is used when less than 1.
+     * @throws LibQGit2::Exception
+     */
+    explicit ParallelRevWalk(const Repository& repository, int threadCount = 0);
+
+    ~ParallelRevWalk();
+
+    /**
+     * Forget all the pushed and hidden commits.
+     */
+    void reset();
+
+    /**
+     * Add the commit with the given oid as the tip of a new range.
+     *
+     * @param oid the oid of the commit to start from.
+     */
+    void push(const OId& oid);
+
+    /**
+     * Add the commit the given reference points to as the tip of a new range.
+     *
+     * @param reference the reference to start from.
+     * @throws LibQGit2::Exception
+     */
+    void push(const Reference& reference);
+
+    /**
+     * Add HEAD as the tip of a new range. On its own it gives a single range,
+     * walked by one thread.
+     *
+     * @throws LibQGit2::Exception
+     */
+    void pushHead();
+
+    /**
+     * Hide the commit with the given oid and its ancestors from every range.
+     *
+     * @param oid the oid of the commit to hide.
+     */
+    void hide(const OId& oid);
+
+    /**
+     * Change the sorting mode of the result.
+     *
+     * With RevWalk::Time the ranges are merged by commit time. Otherwise the ranges
+     * are concatenated, the one of the last pushed tip first, which keeps every
+     * commit before its ancestors when RevWalk::Topological is set.
+     *
+     * @param sortMode The sorting mode @see RevWalk::SortModes.
+     */
+    void setSorting(RevWalk::SortModes sortMode);
+
+    /**
+     * Walk all the ranges and return the ids of the traversed commits.
+     *
+     * @throws LibQGit2::Exception
+     */
+    QVector<OId> walk() const;
+
+private:
+    class Private;
+    QSharedPointer<Private> d_ptr;
+    Q_DECLARE_PRIVATE()
+};
+
+/**@}*/
+}
+
+#endif // LIBQGIT2_PARALLELREVWALK_H
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitrenameoptions.h"
+#include "private/similarity.h"
+
+namespace LibQGit2
+{
+
+namespace {
+    const int DefaultSignatureCacheSize = 32 * 1024 * 1024;
+}
+
+class RenameOptions::Private
+{
+public:
+    Private(Flags flags) :
+        m_signatures(flags.testFlag(IgnoreWhitespace), DefaultSignatureCacheSize)
+    {
+        git_diff_find_options temp = GIT_DIFF_FIND_OPTIONS_INIT;
+        native = temp;
+        native.flags = uint32_t(flags);
+
+        m_signatures.initMetric(m_metric);
+        native.metric = &m_metric;
+    }
+
+    git_diff_find_options native;
+    git_diff_similarity_metric m_metric;
+    internal::SimilarityCache m_signatures;
+};
+
+
+RenameOptions::RenameOptions(Flags flags)
+    : d_ptr(new Private(flags))
+{
+}
+
+RenameOptions::Flags RenameOptions::flags() const
+{
+    return Flags(int(d_ptr->native.flags));
+}
+
+void RenameOptions::setRenameThreshold(quint16 threshold)
+{
+    d_ptr->native.rename_threshold = threshold;
+}
+
+void RenameOptions::setCopyThreshold(quint16 threshold)
+{
+    d_ptr->native.copy_threshold = threshold;
+}
+
+void RenameOptions::setCandidateLimit(quint32 limit)
+{
+    d_ptr->native.rename_limit = limit;
+}
+
+void RenameOptions::setSignatureCacheSize(int bytes)
+{
+    d_ptr->m_signatures.setMaxCost(bytes);
+}
+
+int RenameOptions::cachedSignatures() const
+{
+    return d_ptr->m_signatures.count();
+}
+
+const git_diff_find_options* RenameOptions::data() const
+{
+    return &d_ptr->native;
+}
+
+}
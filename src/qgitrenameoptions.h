@@ -0,0 +1,114 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_RENAMEOPTIONS_H
+#define LIBQGIT2_RENAMEOPTIONS_H
+
+#include "git2.h"
+#include <QSharedPointer>
+#include "libqgit2_export.h"
+
+namespace LibQGit2
+{
+    /**
+     * Options that specify how renamed and copied files are detected in a diff.
+     *
+     * The contents of the files are compared by signatures made of the hashes of
+     * their lines. The signatures of blobs are cached by blob id and shared by all
+     * the copies of a RenameOptions object, so a blob that takes part in several
+     * diffs is hashed only once.
+     *
+     * @see Diff::findRenames()
+     *
+     * @ingroup LibQGit2
+     * @{
+     */
+    class LIBQGIT2_EXPORT RenameOptions
+    {
+    public:
+        /**
+         * Options specifying what to look for.
+         */
+        enum Flag {
+            FindRenames = GIT_DIFF_FIND_RENAMES,                             ///< Look for renames of deleted files
+            FindCopies = GIT_DIFF_FIND_COPIES,                               ///< Look for copies of modified files
+            FindCopiesFromUnmodified = GIT_DIFF_FIND_COPIES_FROM_UNMODIFIED, ///< Look for copies of unmodified files too; the diff must include them
+            FindRewrites = GIT_DIFF_FIND_REWRITES,                           ///< Mark heavily modified files as rewritten
+            BreakRewrites = GIT_DIFF_BREAK_REWRITES,                         ///< Split rewritten files into a deletion and an addition
+            FindForUntracked = GIT_DIFF_FIND_FOR_UNTRACKED,                  ///< Look for renames among untracked files too
+            IgnoreWhitespace = GIT_DIFF_FIND_IGNORE_WHITESPACE,              ///< Ignore whitespace when comparing files
+            ExactMatchOnly = GIT_DIFF_FIND_EXACT_MATCH_ONLY                  ///< Only match files with the same id, without reading them
+        };
+        Q_DECLARE_FLAGS(Flags, Flag)
+
+        /**
+         * Constructs a new RenameOptions with an empty signature cache.
+         * @param flags What to look for.
+         */
+        RenameOptions(Flags flags = FindRenames);
+
+        Flags flags() const;
+
+        /**
+         * Sets the similarity in percent for a deleted and an added file to be
+         * reported as a rename. The default is 50.
+         */
+        void setRenameThreshold(quint16 threshold);
+
+        /**
+         * Sets the similarity in percent for a file to be reported as a copy.
+         * The default is 50.
+         */
+        void setCopyThreshold(quint16 threshold);
+
+        /**
+         * Sets the maximum number of candidate files compared with each other.
+         *
+         * Every source is compared with every target, so the number of comparisons
+         * grows with the square of this limit. When there are more candidates, only
+         * exact renames (with the same id) are detected. The default is 200, or the
+         * diff.renameLimit setting.
+         */
+        void setCandidateLimit(quint32 limit);
+
+        /**
+         * Sets the memory available to the cached signatures, in bytes. The default
+         * is 32 MB.
+         */
+        void setSignatureCacheSize(int bytes);
+
+        /**
+         * Returns the number of signatures in the cache.
+         */
+        int cachedSignatures() const;
+
+        const git_diff_find_options* data() const;
+
+    private:
+        class Private;
+        QSharedPointer<Private> d_ptr;
+        Q_DECLARE_PRIVATE()
+    };
+
+    Q_DECLARE_OPERATORS_FOR_FLAGS(RenameOptions::Flags)
+
+    /** @} */
+
+}
+
+#endif // LIBQGIT2_RENAMEOPTIONS_H
@@ -18,8 +18,11 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
  */
 
+#include <QtCore/QCache>
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
 #include <QtCore/QVector>
 
 #include "qgitrepository.h"
@@ -30,15 +33,57 @@
 #include "qgitexception.h"
 #include "qgitremote.h"
 #include "qgitcredentials.h"
+#include "qgitblame.h"
 #include "qgitdiff.h"
+#include "qgitdiffstats.h"
 #include "private/annotatedcommit.h"
 #include "private/buffer.h"
+#include "private/indexpreload.h"
 #include "private/pathcodec.h"
 #include "private/remotecallbacks.h"
 #include "private/strarray.h"
+#include "private/workerpool.h"
 
 namespace {
     void do_not_free(git_repository*) {}
+
+    /** Takes ownership of \a diff, then looks for renames and copies if \a opts asks to. */
+    LibQGit2::Diff makeDiff(git_diff *diff, const LibQGit2::DiffOptions &opts)
+    {
+        LibQGit2::Diff result(diff, opts);
+        if (opts.findsSimilar()) {
+            LibQGit2::qGitThrow(git_diff_find_similar(diff, opts.findData()));
+        }
+        return result;
+    }
+
+    const int LookupChunkSize = 64;
+    const int LookupQueueLimit = 4096;
+
+    /** Hands the objects read by the workers of Repository::lookupMany() to the calling thread. */
+    struct LookupQueue {
+        explicit LookupQueue(int count) : pending(count), stopped(false) {}
+
+        QMutex mutex;
+        QWaitCondition ready;
+        QWaitCondition drained;
+        QVector<LibQGit2::Object> objects;
+        int pending;
+        bool stopped;
+
+        void stop()
+        {
+            QMutexLocker lock(&mutex);
+            stopped = true;
+            ready.wakeAll();
+            drained.wakeAll();
+        }
+    };
+
+    struct LookupQueueStopper {
+        LookupQueue &queue;
+        ~LookupQueueStopper() { queue.stop(); }
+    };
 }
 
 namespace LibQGit2
@@ -94,6 +139,32 @@ public:
         return d.data();
     }
 
+    /**
+     * Full ids are looked up directly. Short ids are resolved by the object database
+     * first, which finds an ambiguous id without reading any object, and are then
+     * looked up by their full id, which finds the object in the object cache of the
+     * repository when it was read before.
+     */
+    git_object* lookup(const char *funcName, const OId &oid, git_otype type)
+    {
+        git_repository *repo = safeData(funcName);
+        git_object *object = 0;
+        if (oid.isFull()) {
+            qGitThrow(git_object_lookup(&object, repo, oid.constData(), type));
+            return object;
+        }
+
+        git_odb *odb = 0;
+        qGitThrow(git_repository_odb(&odb, repo));
+        git_oid full;
+        int error = git_odb_exists_prefix(&full, odb, oid.constData(), oid.length());
+        git_odb_free(odb);
+        qGitThrow(error);
+
+        qGitThrow(git_object_lookup(&object, repo, &full, type));
+        return object;
+    }
+
     int progress(int transferProgress)
     {
         emit m_owner.cloneProgress(transferProgress);
@@ -227,37 +298,27 @@ Reference Repository::lookupShorthandRef(const QString& shorthand) const
 
 Commit Repository::lookupCommit(const OId& oid) const
 {
-    git_commit *commit = 0;
-    qGitThrow(git_commit_lookup_prefix(&commit, SAFE_DATA, oid.constData(), oid.length()));
-    return Commit(commit);
+    return Commit(reinterpret_cast<git_commit*>(d_ptr->lookup(__func__, oid, GIT_OBJ_COMMIT)));
 }
 
 Tag Repository::lookupTag(const OId& oid) const
 {
-    git_tag *tag = 0;
-    qGitThrow(git_tag_lookup_prefix(&tag, SAFE_DATA, oid.constData(), oid.length()));
-    return Tag(tag);
+    return Tag(reinterpret_cast<git_tag*>(d_ptr->lookup(__func__, oid, GIT_OBJ_TAG)));
 }
 
 Tree Repository::lookupTree(const OId& oid) const
 {
-    git_tree *tree = 0;
-    qGitThrow(git_tree_lookup_prefix(&tree, SAFE_DATA, oid.constData(), oid.length()));
-    return Tree(tree);
+    return Tree(reinterpret_cast<git_tree*>(d_ptr->lookup(__func__, oid, GIT_OBJ_TREE)));
 }
 
 Blob Repository::lookupBlob(const OId& oid) const
 {
-    git_blob *blob = 0;
-    qGitThrow(git_blob_lookup_prefix(&blob, SAFE_DATA, oid.constData(), oid.length()));
-    return Blob(blob);
+    return Blob(reinterpret_cast<git_blob*>(d_ptr->lookup(__func__, oid, GIT_OBJ_BLOB)));
 }
 
 Object Repository::lookupAny(const OId &oid) const
 {
-    git_object *object = 0;
-    qGitThrow(git_object_lookup_prefix(&object, SAFE_DATA, oid.constData(), oid.length(), GIT_OBJ_ANY));
-    return Object(object);
+    return Object(d_ptr->lookup(__func__, oid, GIT_OBJ_ANY));
 }
 
 Object Repository::lookupRevision(const QString &revspec) const
@@ -267,6 +328,78 @@ Object Repository::lookupRevision(const QString &revspec) const
     return Object(object);
 }
 
+void Repository::lookupMany(const QVector<OId>& oids, const std::function<void(const Object&)>& callback, int threadCount) const
+{
+    if (oids.isEmpty()) {
+        return;
+    }
+
+    LookupQueue queue(oids.size());
+    internal::WorkerPool pool(path(), threadCount);
+    LookupQueueStopper stopper = { queue };
+
+    const OId *input = oids.constData();
+    const int total = oids.size();
+    const int chunks = (total + LookupChunkSize - 1) / LookupChunkSize;
+    pool.start(chunks, [input, total, &queue](internal::WorkerPool::Worker &worker, int chunk) {
+        const int begin = chunk * LookupChunkSize;
+        const int end = qMin(begin + LookupChunkSize, total);
+
+        QVector<Object> objects;
+        objects.reserve(end - begin);
+        try {
+            for (int i = begin; i < end; ++i) {
+                git_object *object = 0;
+                if (input[i].isFull()) {
+                    qGitThrow(git_object_lookup(&object, worker.handle.data(), input[i].constData(), GIT_OBJ_ANY));
+                } else {
+                    qGitThrow(git_object_lookup_prefix(&object, worker.handle.data(), input[i].constData(), input[i].length(), GIT_OBJ_ANY));
+                }
+
+                // the object must not outlive the worker handle it belongs to
+                Object result;
+                QSharedPointer<git_repository> handle = worker.handle;
+                result.d = QSharedPointer<git_object>(object, [handle](git_object *o) { git_object_free(o); });
+                objects.append(result);
+            }
+        } catch (...) {
+            queue.stop();
+            throw;
+        }
+
+        QMutexLocker lock(&queue.mutex);
+        while (queue.objects.size() >= LookupQueueLimit && !queue.stopped) {
+            queue.drained.wait(&queue.mutex);
+        }
+        queue.objects += objects;
+        queue.pending -= objects.size();
+        queue.ready.wakeOne();
+    });
+
+    QVector<Object> batch;
+    forever {
+        {
+            QMutexLocker lock(&queue.mutex);
+            while (queue.objects.isEmpty() && queue.pending > 0 && !queue.stopped) {
+                queue.ready.wait(&queue.mutex);
+            }
+            if (queue.objects.isEmpty()) {
+                break;
+            }
+            batch.swap(queue.objects);
+            queue.drained.wakeAll();
+        }
+
+        foreach (const Object &object, batch) {
+            callback(object);
+        }
+        batch.clear();
+    }
+
+    // rethrows the error of a worker, if any
+    pool.wait();
+}
+
 Reference Repository::createRef(const QString& name, const LibQGit2::OId& oid, bool overwrite, const QString &message)
 {
     git_reference *ref = 0;
@@ -402,6 +535,21 @@ Index Repository::index() const
 
 StatusList Repository::status(const StatusOptions &options) const
 {
+    if (options.threadCount() != 1 && options.showType() != StatusOptions::ShowOnlyIndex) {
+        git_index *idx = NULL;
+        qGitThrow(git_repository_index(&idx, SAFE_DATA));
+        QSharedPointer<git_index> index(idx, git_index_free);
+        qGitThrow(git_index_read(idx, 0));
+        // libgit2 rehashes the files newer than the index file, so the refreshed
+        // entries only help once written; like git, give up if the index is locked
+        if (internal::preloadIndex(*this, idx, options.threadCount()) > 0) {
+            int error = git_index_write(idx);
+            if (error != GIT_ELOCKED) {
+                qGitThrow(error);
+            }
+        }
+    }
+
     const git_status_options opt = options.constData();
     git_status_list *status_list;
     qGitThrow(git_status_list_new(&status_list, SAFE_DATA, &opt));
@@ -415,11 +563,71 @@ Repository::GraphRelationship Repository::commitRelationship(const Commit &local
     return result;
 }
 
-Diff Repository::diffTrees(const Tree &oldTree, const Tree &newTree) const
+Diff Repository::diffTrees(const Tree &oldTree, const Tree &newTree, const DiffOptions &opts) const
 {
     git_diff *diff = NULL;
-    qGitThrow(git_diff_tree_to_tree(&diff, SAFE_DATA, oldTree.data(), newTree.data(), NULL));
-    return Diff(diff);
+    qGitThrow(git_diff_tree_to_tree(&diff, SAFE_DATA, oldTree.data(), newTree.data(), opts.data()));
+    return makeDiff(diff, opts);
+}
+
+Diff Repository::diffIndexToWorkdir(const Index &index, const DiffOptions &opts) const
+{
+    git_diff *diff = NULL;
+    qGitThrow(git_diff_index_to_workdir(&diff, SAFE_DATA, index.data(), opts.data()));
+    return makeDiff(diff, opts);
+}
+
+Diff Repository::diffTreeToIndex(const Tree &oldTree, const Index &index, const DiffOptions &opts) const
+{
+    git_diff *diff = NULL;
+    qGitThrow(git_diff_tree_to_index(&diff, SAFE_DATA, oldTree.data(), index.data(), opts.data()));
+    return makeDiff(diff, opts);
+}
+
+Diff Repository::diffTreeToWorkdirWithIndex(const Tree &oldTree, const DiffOptions &opts) const
+{
+    git_diff *diff = NULL;
+    qGitThrow(git_diff_tree_to_workdir_with_index(&diff, SAFE_DATA, oldTree.data(), opts.data()));
+    return makeDiff(diff, opts);
+}
+
+Blame Repository::blameFile(const QString &path, const OId &newestCommit, const OId &oldestCommit) const
+{
+    git_blame_options opts = GIT_BLAME_OPTIONS_INIT;
+    if (newestCommit.isValid()) {
+        opts.newest_commit = *newestCommit.constData();
+    }
+    if (oldestCommit.isValid()) {
+        opts.oldest_commit = *oldestCommit.constData();
+    }
+
+    git_blame *blame = NULL;
+    qGitThrow(git_blame_file(&blame, SAFE_DATA, PathCodec::toLibGit2(path).constData(), &opts));
+    return Blame(blame);
+}
+
+QVector<DiffStats> Repository::diffStatsForCommits(const QVector<OId> &commits, const DiffOptions &opts) const
+{
+    // consecutive commits of a history share a tree: the parent's of one is the other's
+    QCache<OId, Tree> trees(16);
+    auto treeOf = [this, &trees](const OId &oid, const Commit *commit) -> Tree {
+        if (Tree *tree = trees.object(oid)) {
+            return *tree;
+        }
+        Tree tree = commit ? commit->tree() : lookupCommit(oid).tree();
+        trees.insert(oid, new Tree(tree));
+        return tree;
+    };
+
+    QVector<DiffStats> result;
+    result.reserve(commits.size());
+    foreach (const OId &oid, commits) {
+        Commit commit = lookupCommit(oid);
+        Tree newTree = treeOf(oid, &commit);
+        Tree oldTree = commit.parentCount() > 0 ? treeOf(commit.parentId(0), 0) : Tree();
+        result.append(diffTrees(oldTree, newTree, opts).stats());
+    }
+    return result;
 }
 
 Commit Repository::mergeBase(const Commit &one, const Commit &two) const
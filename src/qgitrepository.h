@@ -25,6 +25,9 @@
 #include <QtCore/QStringList>
 #include <QtCore/QObject>
 #include <QtCore/QMap>
+#include <QtCore/QVector>
+
+#include <functional>
 
 // #include "libqgit2_export.h"
 
@@ -37,6 +40,7 @@
 #include "qgitstatuslist.h"
 #include "qgitstatusoptions.h"
 #include "qgitcheckoutoptions.h"
+#include "qgitdiffoptions.h"
 #include "qgitmergeoptions.h"
 #include "qgitcherrypickoptions.h"
 #include "qgitrebase.h"
@@ -53,6 +57,8 @@ namespace LibQGit2
     class Credentials;
     class Remote;
     class Diff;
+    class DiffStats;
+    class Blame;
 
     /**
      * @brief Wrapper class for git_repository.
@@ -258,6 +264,10 @@ namespace LibQGit2
             /**
              * Lookup a commit object from a repository.
              *
+             * A full \a oid is looked up directly. A short one is resolved to a full id
+             * first, without reading the object, so that looking up the same short id
+             * again finds the object in the object cache like a full one.
+             *
              * @throws LibQGit2::Exception
              */
             Commit lookupCommit(const OId& oid) const;
@@ -285,6 +295,7 @@ namespace LibQGit2
 
             /**
              * Lookup a reference to one of the objects in a repostory.
+             * Short ids are resolved as in lookupCommit().
              *
              * @throws LibQGit2::Exception
              */
@@ -302,6 +313,27 @@ namespace LibQGit2
              */
             Object lookupRevision(const QString &revspec) const;
 
+            /**
+             * @brief Looks up many objects on several threads.
+             *
+             * The ids are split into consecutive chunks which are read by worker threads,
+             * each one with its own handle on the repository, so keeping ids of objects
+             * that are stored close to each other (e.g. in traversal order) next to each
+             * other in \a oids helps the reads. Short ids are resolved as by lookupAny().
+             *
+             * \a callback is invoked on the calling thread, once per object, in the order
+             * in which the lookups complete. The objects passed to it keep the handle
+             * they were read through alive, so they can be stored.
+             *
+             * @param oids the ids of the objects to look up
+             * @param callback called with every object found
+             * @param threadCount the number of worker threads; the ideal thread count
+             * of the machine is used when less than 1.
+             * @throws LibQGit2::Exception the first lookup error; the remaining objects
+             * are not looked up then.
+             */
+            void lookupMany(const QVector<OId>& oids, const std::function<void(const Object&)>& callback, int threadCount = 0) const;
+
             /**
              * Create a new object id reference.
              *
@@ -466,7 +498,8 @@ namespace LibQGit2
              * @brief Get the status information of the Git repository
              *
              * This function returns the status of the repository entries, according to
-             * the given options.
+             * the given options. See StatusOptions::setThreadCount() to check the files
+             * on several threads first.
              *
              * @throws LibQGit2::Exception
              * @return The list of status entries
@@ -504,12 +537,90 @@ namespace LibQGit2
              *
              * Either Tree argument can be a NULL Tree, but not both.
              *
+             * When \a opts restricts the diff to some paths, only the subtrees that
+             * can contain them are read. Renames and copies are detected after the
+             * diff is made, if \a opts enables them.
+             *
              * @param oldTree the Tree on the `old' side of the diff.
              * @param newTree the Tree on the `new' side of the diff.
+             * @param opts Options specifying how the diff is computed.
              * @throws LibQGit2::Exception
              * @return The Diff between the provided Trees.
              */
-            Diff diffTrees(const Tree &oldTree, const Tree &newTree) const;
+            Diff diffTrees(const Tree &oldTree, const Tree &newTree, const DiffOptions &opts = DiffOptions()) const;
+
+            /**
+             * @brief Makes a Diff between an Index and the working directory.
+             *
+             * A file whose size, modification time and inode match its index entry is
+             * considered unchanged without being read. The other files are hashed; with
+             * the DiffOptions::UpdateIndex flag the stat data of those found unchanged is
+             * stored in the index, which is then written, so that the next diff does not
+             * read them again.
+             *
+             * @param index the Index on the `old' side of the diff; the index of the
+             * repository if it is a NULL Index.
+             * @param opts Options specifying how the diff is computed.
+             * @throws LibQGit2::Exception
+             * @return The Diff between the Index and the working directory.
+             */
+            Diff diffIndexToWorkdir(const Index &index = Index(), const DiffOptions &opts = DiffOptions()) const;
+
+            /**
+             * @brief Makes a Diff between a Tree and an Index.
+             *
+             * @param oldTree the Tree on the `old' side of the diff; can be a NULL Tree.
+             * @param index the Index on the `new' side of the diff; the index of the
+             * repository if it is a NULL Index.
+             * @param opts Options specifying how the diff is computed.
+             * @throws LibQGit2::Exception
+             * @return The Diff between the Tree and the Index.
+             */
+            Diff diffTreeToIndex(const Tree &oldTree, const Index &index = Index(), const DiffOptions &opts = DiffOptions()) const;
+
+            /**
+             * @brief Makes a Diff between a Tree and the working directory.
+             *
+             * The index of the repository is used as in `git diff <tree>`: files that
+             * are staged for deletion show up as deleted, and unchanged files are
+             * recognized by their stat data as in diffIndexToWorkdir(), including with
+             * the DiffOptions::UpdateIndex flag.
+             *
+             * @param oldTree the Tree on the `old' side of the diff; can be a NULL Tree.
+             * @param opts Options specifying how the diff is computed.
+             * @throws LibQGit2::Exception
+             * @return The Diff between the Tree and the working directory.
+             */
+            Diff diffTreeToWorkdirWithIndex(const Tree &oldTree, const DiffOptions &opts = DiffOptions()) const;
+
+            /**
+             * @brief Finds the commits that last changed each line of a file.
+             *
+             * @param path the path of the file, relative to the working directory
+             * @param newestCommit the version of the file to blame; HEAD if it is not valid
+             * @param oldestCommit the commit to stop at; lines not changed since are
+             * attributed to it as boundary hunks. The history is followed to the root
+             * commits if it is not valid.
+             * @throws LibQGit2::Exception
+             * @see BlameCache
+             */
+            Blame blameFile(const QString &path, const OId &newestCommit = OId(), const OId &oldestCommit = OId()) const;
+
+            /**
+             * @brief Counts the added and deleted lines of many commits.
+             *
+             * Every commit is diffed against its first parent, or against an empty tree
+             * if it has none. The trees of the recently seen commits are kept, so when
+             * \a commits lists a history in order (e.g. as returned by a RevWalk) each
+             * tree is loaded only once.
+             *
+             * @param commits the ids of the commits
+             * @param opts Options specifying how the diffs are computed.
+             * @return the stats of each commit, in the order of \a commits.
+             * @throws LibQGit2::Exception
+             * @see Diff::stats()
+             */
+            QVector<DiffStats> diffStatsForCommits(const QVector<OId> &commits, const DiffOptions &opts = DiffOptions()) const;
 
             /**
              * Finds a merge base between two commits.
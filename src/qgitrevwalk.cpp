@@ -22,6 +22,7 @@
 
 #include "qgitrevwalk.h"
 #include "qgitcommit.h"
+#include "qgitcommitbatch.h"
 #include "qgitref.h"
 #include "qgitexception.h"
 #include "qgitrepository.h"
@@ -125,6 +126,43 @@ bool RevWalk::next(Commit& commit)
     return !commit.isNull();
 }
 
+bool RevWalk::nextBatch(CommitBatch& batch, int n)
+{
+    batch.clear();
+
+    git_odb *odb = 0;
+    qGitThrow(git_repository_odb(&odb, git_revwalk_repository(m_revWalk)));
+    QSharedPointer<git_odb> odbGuard(odb, git_odb_free);
+
+    git_oid oid;
+    while (batch.count() < n) {
+        int err = git_revwalk_next(&oid, m_revWalk);
+        if (err == GIT_ITEROVER) {
+            break;
+        }
+        qGitThrow(err);
+
+        git_odb_object *obj = 0;
+        qGitThrow(git_odb_read(&obj, odb, &oid));
+        try {
+            batch.append(&oid, static_cast<const char*>(git_odb_object_data(obj)), git_odb_object_size(obj));
+        } catch (...) {
+            git_odb_object_free(obj);
+            throw;
+        }
+        git_odb_object_free(obj);
+    }
+
+    return !batch.isEmpty();
+}
+
+CommitBatch RevWalk::nextBatch(int n)
+{
+    CommitBatch batch;
+    nextBatch(batch, n);
+    return batch;
+}
+
 void RevWalk::setSorting(SortModes sm)
 {
     git_revwalk_sorting(m_revWalk, sm);
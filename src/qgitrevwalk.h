@@ -34,6 +34,7 @@ class Exception;
 class Repository;
 class OId;
 class Commit;
+class CommitBatch;
 class Reference;
 
 /**
@@ -209,6 +210,30 @@ public:
      */
     bool next(Commit& commit);
 
+    /**
+     * Get the metadata of up to \a n next commits from the revision traversal.
+     *
+     * Unlike next(Commit&), this method does not create a Commit object for every
+     * commit. The raw commits are parsed directly into the flat records of \a batch,
+     * whose previous content is discarded but whose memory is reused.
+     *
+     * @param batch The batch to fill.
+     * @param n The maximal number of commits to read.
+     * @return True when at least one commit was read.
+     * @throws LibQGit2::Exception
+     */
+    bool nextBatch(CommitBatch& batch, int n);
+
+    /**
+     * Get the metadata of up to \a n next commits from the revision traversal.
+     *
+     * This is a convenience overload of nextBatch(CommitBatch&, int); the returned
+     * batch is empty when the traversal is over.
+     *
+     * @throws LibQGit2::Exception
+     */
+    CommitBatch nextBatch(int n);
+
     /**
      * Change the sorting mode when iterating through the
      * repository's contents.
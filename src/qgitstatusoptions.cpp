@@ -24,6 +24,7 @@ namespace LibQGit2
 {
 
 StatusOptions::StatusOptions(ShowType aShowType, StatusFlags aStatusFlags)
+    : thread_count(1)
 {
     std::memset((void*)&d, 0, sizeof(git_status_options));
     d.version = GIT_STATUS_OPTIONS_VERSION;
@@ -32,12 +33,18 @@ StatusOptions::StatusOptions(ShowType aShowType, StatusFlags aStatusFlags)
 }
 
 StatusOptions::StatusOptions(git_status_options status_options)
-    : d(status_options)
+    : d(status_options),
+      show_type(ShowType(status_options.show)),
+      status_flags(StatusFlags(int(status_options.flags))),
+      thread_count(1)
 {
 }
 
 StatusOptions::StatusOptions(const StatusOptions &other)
-    : d(other.d)
+    : d(other.d),
+      show_type(other.show_type),
+      status_flags(other.status_flags),
+      thread_count(other.thread_count)
 {
 }
 
@@ -68,6 +75,16 @@ void StatusOptions::setStatusFlags(StatusOptions::StatusFlags sf)
     d.flags = status_flags;
 }
 
+int StatusOptions::threadCount() const
+{
+    return thread_count;
+}
+
+void StatusOptions::setThreadCount(int threadCount)
+{
+    thread_count = threadCount;
+}
+
 git_status_options StatusOptions::data() const
 {
     return d;
@@ -60,7 +60,8 @@ public:
         RenamesHeadToIndex = GIT_STATUS_OPT_RENAMES_HEAD_TO_INDEX,
         RenamesIndexToWorkdir = GIT_STATUS_OPT_RENAMES_INDEX_TO_WORKDIR,
         SortCaseSensitively = GIT_STATUS_OPT_SORT_CASE_SENSITIVELY,
-        SortCaseInsensitively = GIT_STATUS_OPT_SORT_CASE_INSENSITIVELY
+        SortCaseInsensitively = GIT_STATUS_OPT_SORT_CASE_INSENSITIVELY,
+        UpdateIndex = GIT_STATUS_OPT_UPDATE_INDEX
     };
 
     Q_DECLARE_FLAGS(StatusFlags, StatusFlag)
@@ -81,6 +82,20 @@ public:
 
     void setStatusFlags(StatusOptions::StatusFlags sf);
 
+    int threadCount() const;
+
+    /**
+     * Sets the number of threads that check the files of the index before the status
+     * is computed.
+     *
+     * With more than one thread the files are stat'ed, and hashed if their stat data
+     * changed, in parallel. The entries of the files found unchanged get the new stat
+     * data and the index is written, as `git status` does, so libgit2 then only has to
+     * look at the files that really changed. The default is 1, which leaves everything
+     * to libgit2; the ideal thread count of the machine is used when less than 1.
+     */
+    void setThreadCount(int threadCount);
+
     git_status_options data() const;
     const git_status_options constData() const;
 
@@ -89,6 +104,7 @@ private:
 
     ShowType show_type;
     StatusFlags status_flags;
+    int thread_count;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(StatusOptions::StatusFlags)
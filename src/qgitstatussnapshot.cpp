@@ -0,0 +1,144 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitstatussnapshot.h"
+
+#include <QtCore/QVector>
+
+#include "qgitstatuslist.h"
+#include "private/pathcodec.h"
+
+namespace LibQGit2
+{
+
+namespace {
+    struct PathRange {
+        int start;
+        int length;
+    };
+}
+
+class StatusSnapshot::Private
+{
+public:
+    Private() {}
+
+    explicit Private(git_status_list *list)
+    {
+        const int count = list ? int(git_status_list_entrycount(list)) : 0;
+        m_status.reserve(count);
+        m_paths.reserve(count);
+        m_oldPaths.reserve(count);
+        m_headIds.reserve(count);
+        m_indexIds.reserve(count);
+        m_workdirIds.reserve(count);
+
+        const git_oid zero = {{ 0 }};
+        for (int i = 0; i < count; ++i) {
+            const git_status_entry *entry = git_status_byindex(list, size_t(i));
+            const git_diff_delta *headToIndex = entry->head_to_index;
+            const git_diff_delta *indexToWorkdir = entry->index_to_workdir;
+
+            m_status.append(entry->status);
+
+            const char *path = indexToWorkdir ? indexToWorkdir->new_file.path : headToIndex->new_file.path;
+            const char *oldPath = headToIndex ? headToIndex->old_file.path : indexToWorkdir->old_file.path;
+            m_paths.append(appendPath(path));
+            m_oldPaths.append(qstrcmp(path, oldPath) == 0 ? m_paths.last() : appendPath(oldPath));
+
+            m_headIds.append(headToIndex ? headToIndex->old_file.id : zero);
+            m_indexIds.append(headToIndex ? headToIndex->new_file.id : indexToWorkdir->old_file.id);
+            m_workdirIds.append(indexToWorkdir ? indexToWorkdir->new_file.id : zero);
+        }
+        m_pool.squeeze();
+    }
+
+    PathRange appendPath(const char *path)
+    {
+        const QString converted = PathCodec::fromLibGit2(path);
+        const PathRange range = { m_pool.size(), converted.size() };
+        m_pool += converted;
+        return range;
+    }
+
+    QStringView view(const PathRange &range) const
+    {
+        return QStringView(m_pool).mid(range.start, range.length);
+    }
+
+    QVector<unsigned int> m_status;
+    QVector<PathRange> m_paths;
+    QVector<PathRange> m_oldPaths;
+    QVector<git_oid> m_headIds;
+    QVector<git_oid> m_indexIds;
+    QVector<git_oid> m_workdirIds;
+    QString m_pool;
+};
+
+
+StatusSnapshot::StatusSnapshot()
+    : d_ptr(new Private)
+{
+}
+
+StatusSnapshot::StatusSnapshot(const StatusList &list)
+    : d_ptr(new Private(list.data()))
+{
+}
+
+int StatusSnapshot::count() const
+{
+    return d_ptr->m_status.size();
+}
+
+Status StatusSnapshot::status(int index) const
+{
+    return Status(git_status_t(rawStatus(index)));
+}
+
+unsigned int StatusSnapshot::rawStatus(int index) const
+{
+    return d_ptr->m_status.at(index);
+}
+
+QStringView StatusSnapshot::path(int index) const
+{
+    return d_ptr->view(d_ptr->m_paths.at(index));
+}
+
+QStringView StatusSnapshot::oldPath(int index) const
+{
+    return d_ptr->view(d_ptr->m_oldPaths.at(index));
+}
+
+OId StatusSnapshot::headId(int index) const
+{
+    return OId(&d_ptr->m_headIds.at(index));
+}
+
+OId StatusSnapshot::indexId(int index) const
+{
+    return OId(&d_ptr->m_indexIds.at(index));
+}
+
+OId StatusSnapshot::workdirId(int index) const
+{
+    return OId(&d_ptr->m_workdirIds.at(index));
+}
+
+}
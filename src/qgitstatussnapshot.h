@@ -0,0 +1,121 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_STATUS_SNAPSHOT_H
+#define LIBQGIT2_STATUS_SNAPSHOT_H
+
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+#include <QtCore/QStringView>
+
+#include "git2.h"
+
+#include "libqgit2_export.h"
+#include "qgitoid.h"
+#include "qgitstatus.h"
+
+namespace LibQGit2
+{
+
+class StatusList;
+
+/**
+ * @brief A copy of a StatusList laid out for random access.
+ *
+ * The entries are converted once, when the snapshot is made, into flat arrays:
+ * one for the status flags, one per side for the object ids, and the paths as
+ * ranges of a single string. Reading an entry then neither allocates nor converts
+ * anything, which suits item models that query many rows at every repaint.
+ *
+ * Copies of a snapshot share their data.
+ *
+ * @ingroup LibQGit2
+ * @{
+ */
+class LIBQGIT2_EXPORT StatusSnapshot
+{
+public:
+    /**
+     * Creates an empty snapshot.
+     */
+    StatusSnapshot();
+
+    /**
+     * Copies the entries of \a list.
+     */
+    explicit StatusSnapshot(const StatusList &list);
+
+    /**
+     * Returns the number of entries.
+     */
+    int count() const;
+
+    bool isEmpty() const { return count() == 0; }
+
+    /**
+     * Returns the status of the entry at \a index.
+     *
+     * @param index an index from the interval 0 <= index < count().
+     */
+    Status status(int index) const;
+
+    /**
+     * Returns the status flags of the entry at \a index, a combination of git_status_t values.
+     */
+    unsigned int rawStatus(int index) const;
+
+    /**
+     * Returns the path of the entry at \a index: the path in the working directory,
+     * or in the index if the file is not in the working directory.
+     *
+     * The view points into the snapshot and is valid as long as the snapshot, or a
+     * copy of it, exists.
+     */
+    QStringView path(int index) const;
+
+    /**
+     * Returns the path the entry at \a index had in HEAD, which differs from path() for
+     * renamed files. The view is valid as long as the snapshot exists.
+     */
+    QStringView oldPath(int index) const;
+
+    /**
+     * Returns the id of the file in HEAD, or an invalid OId if it is not in HEAD.
+     */
+    OId headId(int index) const;
+
+    /**
+     * Returns the id of the file in the index, or an invalid OId if it is not in the index.
+     */
+    OId indexId(int index) const;
+
+    /**
+     * Returns the id of the file in the working directory, or an invalid OId if it was
+     * not computed, which is the case for most modified and untracked files.
+     */
+    OId workdirId(int index) const;
+
+private:
+    class Private;
+    QSharedPointer<const Private> d_ptr;
+};
+
+/**@}*/
+}
+
+#endif // LIBQGIT2_STATUS_SNAPSHOT_H
@@ -0,0 +1,662 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgitstatuswatcher.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFileSystemWatcher>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QTimer>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "qgitexception.h"
+#include "qgitrepository.h"
+#include "private/pathcodec.h"
+
+namespace LibQGit2
+{
+
+namespace {
+    const int DefaultDebounceInterval = 50;
+
+    /** The interval of the full scans when some directories can not be watched. */
+    const int PollInterval = 5000;
+
+    QString joinPath(const QString &dir, const QString &name)
+    {
+        return dir.isEmpty() ? name : dir + QLatin1Char('/') + name;
+    }
+
+    /** Checks if \a path is inside \a dir, or directly inside it if not \a recursive. */
+    bool isInside(const QString &path, const QString &dir, bool recursive)
+    {
+        if (!dir.isEmpty() && !(path.startsWith(dir) && path.size() > dir.size() && path.at(dir.size()) == QLatin1Char('/'))) {
+            return false;
+        }
+        return recursive || path.indexOf(QLatin1Char('/'), dir.isEmpty() ? 0 : dir.size() + 1) < 0;
+    }
+
+#ifdef Q_OS_LINUX
+    const uint32_t DirectoryEvents = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE |
+                                     IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_DONTFOLLOW;
+    const uint32_t GitDirEvents = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR;
+#endif
+}
+
+class StatusWatcher::Private
+{
+public:
+    Private(StatusWatcher *q, const Repository &repository) :
+        q_ptr(q),
+        m_repository(repository),
+        m_refWatch(-1),
+        m_inotify(-1),
+        m_gitWatch(-1),
+        m_notifier(0),
+        m_watcher(0),
+        m_rescan(false)
+    {
+        m_timer.setSingleShot(true);
+        m_timer.setInterval(DefaultDebounceInterval);
+        m_pollTimer.setInterval(PollInterval);
+    }
+
+    ~Private()
+    {
+        close();
+    }
+
+    bool isActive() const
+    {
+        return m_inotify >= 0 || m_watcher;
+    }
+
+    void open()
+    {
+        if (m_repository.workDirPath().isEmpty()) {
+            throw Exception("Cannot watch the status of a bare repository.", Exception::Repository);
+        }
+        m_workDir = QDir::cleanPath(m_repository.workDirPath());
+        m_gitDir = QDir::cleanPath(m_repository.path());
+        m_commonDir = QDir::cleanPath(QFile::decodeName(git_repository_commondir(m_repository.data())));
+
+#ifdef Q_OS_LINUX
+        m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_inotify >= 0) {
+            m_gitWatch = inotify_add_watch(m_inotify, QFile::encodeName(m_gitDir).constData(), GitDirEvents);
+            m_notifier = new QSocketNotifier(m_inotify, QSocketNotifier::Read, q_ptr);
+            QObject::connect(m_notifier, &QSocketNotifier::activated, q_ptr, &StatusWatcher::readEvents);
+            return;
+        }
+#endif
+        m_watcher = new QFileSystemWatcher(q_ptr);
+        m_watcher->addPath(m_gitDir);
+        QObject::connect(m_watcher, &QFileSystemWatcher::directoryChanged, q_ptr, &StatusWatcher::directoryChanged);
+    }
+
+    void close()
+    {
+        delete m_notifier;
+        m_notifier = 0;
+#ifdef Q_OS_LINUX
+        if (m_inotify >= 0) {
+            ::close(m_inotify);
+            m_inotify = -1;
+            m_gitWatch = -1;
+            m_refWatch = -1;
+        }
+#endif
+        delete m_watcher;
+        m_watcher = 0;
+        m_refDir.clear();
+        m_refName.clear();
+
+        m_timer.stop();
+        m_pollTimer.stop();
+        m_directories.clear();
+        m_watches.clear();
+        m_dirtyFiles.clear();
+        m_dirtyDirectories.clear();
+        m_rescan = false;
+    }
+
+    QString relativePath(const QString &absolute) const
+    {
+        const QString path = QDir::cleanPath(absolute);
+        return path == m_workDir ? QString() : path.mid(m_workDir.size() + 1);
+    }
+
+    bool isIgnoredDirectory(const QString &path) const
+    {
+        if (path.isEmpty()) {
+            return false;
+        }
+        if (path == QLatin1String(".git")) {
+            return true;
+        }
+        int ignored = 0;
+        qGitThrow(git_ignore_path_is_ignored(&ignored, m_repository.data(), PathCodec::toLibGit2(path + QLatin1Char('/')).constData()));
+        return ignored;
+    }
+
+    void addWatch(const QString &path)
+    {
+        if (m_watches.contains(path)) {
+            return;
+        }
+        const QString absolute = joinPath(m_workDir, path);
+#ifdef Q_OS_LINUX
+        if (m_inotify >= 0) {
+            int wd = inotify_add_watch(m_inotify, QFile::encodeName(absolute).constData(), DirectoryEvents);
+            if (wd >= 0) {
+                m_directories.insert(wd, path);
+                m_watches.insert(path, wd);
+            } else if (errno != ENOENT && errno != ENOTDIR) {
+                // e.g. ENOSPC when the watches of the user are exhausted
+                watchFailed(absolute, QString::fromLocal8Bit(std::strerror(errno)));
+            }
+            return;
+        }
+#endif
+        if (m_watcher->addPath(absolute)) {
+            m_watches.insert(path, 0);
+        } else if (QDir(absolute).exists()) {
+            watchFailed(absolute, QLatin1String("the file system watcher refused it"));
+        }
+    }
+
+    /** Falls back to periodic full scans, as changes inside \a absolute will be missed. */
+    void watchFailed(const QString &absolute, const QString &reason)
+    {
+        if (m_pollTimer.isActive()) {
+            return;
+        }
+        m_pollTimer.start();
+        emit q_ptr->error(QString("Cannot watch %1 (%2), rescanning every %3 ms").arg(absolute, reason).arg(PollInterval));
+    }
+
+    /** Stops watching \a path and the directories inside it. */
+    void removeTree(const QString &path)
+    {
+        foreach (const QString &watched, m_watches.keys()) {
+            if (isInside(watched, path, true)) {
+                removeWatch(watched);
+            }
+        }
+        removeWatch(path);
+    }
+
+    /**
+     * Watches the directory of the branch HEAD points to, where the new id of the
+     * branch is written, or the nearest of its parent directories that exists.
+     */
+    void watchHeadRef()
+    {
+        QString ref;
+        git_reference *head = NULL;
+        if (git_reference_lookup(&head, m_repository.data(), "HEAD") == GIT_OK) {
+            if (git_reference_type(head) == GIT_REF_SYMBOLIC) {
+                ref = PathCodec::fromLibGit2(git_reference_symbolic_target(head));
+            }
+            git_reference_free(head);
+        }
+
+        QString dir;
+        QString name;
+        if (!ref.isEmpty()) {
+            const QStringList parts = ref.split(QLatin1Char('/'));
+            dir = m_commonDir;
+            int i = 0;
+            while (i < parts.size() - 1 && QDir(joinPath(dir, parts.at(i))).exists()) {
+                dir = joinPath(dir, parts.at(i++));
+            }
+            name = parts.at(i);
+        }
+        if (dir == m_refDir) {
+            m_refName = name;
+            return;
+        }
+
+        unwatchHeadRef();
+        m_refDir = dir;
+        m_refName = name;
+        if (dir.isEmpty()) {
+            return;
+        }
+#ifdef Q_OS_LINUX
+        if (m_inotify >= 0) {
+            // the watch of the git directory is returned again for the same directory
+            m_refWatch = inotify_add_watch(m_inotify, QFile::encodeName(dir).constData(), GitDirEvents);
+            if (m_refWatch < 0) {
+                watchFailed(dir, QString::fromLocal8Bit(std::strerror(errno)));
+            }
+            return;
+        }
+#endif
+        if (dir != m_gitDir && !m_watcher->addPath(dir)) {
+            watchFailed(dir, QLatin1String("the file system watcher refused it"));
+        }
+    }
+
+    void unwatchHeadRef()
+    {
+#ifdef Q_OS_LINUX
+        if (m_inotify >= 0 && m_refWatch >= 0 && m_refWatch != m_gitWatch) {
+            inotify_rm_watch(m_inotify, m_refWatch);
+        }
+        m_refWatch = -1;
+#endif
+        if (m_watcher && !m_refDir.isEmpty() && m_refDir != m_gitDir) {
+            m_watcher->removePath(m_refDir);
+        }
+        m_refDir.clear();
+        m_refName.clear();
+    }
+
+    void removeWatch(const QString &path)
+    {
+        if (!m_watches.contains(path)) {
+            return;
+        }
+        const int wd = m_watches.take(path);
+#ifdef Q_OS_LINUX
+        if (m_inotify >= 0) {
+            // the watch of a deleted directory is gone already
+            inotify_rm_watch(m_inotify, wd);
+            m_directories.remove(wd);
+            return;
+        }
+#endif
+        Q_UNUSED(wd);
+        m_watcher->removePath(joinPath(m_workDir, path));
+    }
+
+    /** Watches \a path and its subdirectories that are not ignored. */
+    void watchTree(const QString &path)
+    {
+        addWatch(path);
+        const QStringList names = QDir(joinPath(m_workDir, path)).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+        foreach (const QString &name, names) {
+            const QString child = joinPath(path, name);
+            if (!isIgnoredDirectory(child)) {
+                watchTree(child);
+            }
+        }
+    }
+
+    void schedule()
+    {
+        if (!m_timer.isActive()) {
+            m_timer.start();
+        }
+    }
+
+#ifdef Q_OS_LINUX
+    void handleEvent(int wd, uint32_t mask, const QString &name)
+    {
+        if (mask & IN_Q_OVERFLOW) {
+            m_rescan = true;
+        } else if (wd == m_gitWatch || wd == m_refWatch) {
+            // a branch is written to a lock file, which is then renamed
+            if ((wd == m_gitWatch && (name == QLatin1String("index") || name == QLatin1String("HEAD") ||
+                                      name == QLatin1String("packed-refs"))) ||
+                (wd == m_refWatch && name == m_refName)) {
+                m_rescan = true;
+            }
+        } else if (mask & IN_IGNORED) {
+            // also sent for the watches removed on purpose, which are forgotten already
+            if (m_directories.contains(wd)) {
+                m_watches.remove(m_directories.take(wd));
+            }
+        } else if (m_directories.contains(wd) && !name.isEmpty()) {
+            const QString path = joinPath(m_directories.value(wd), name);
+            if (mask & IN_ISDIR) {
+                // a moved directory keeps its watches: drop them, and watch it again
+                // under its new name when the IN_MOVED_TO event is handled
+                if (mask & IN_MOVED_FROM) {
+                    removeTree(path);
+                }
+                m_dirtyDirectories.insert(path);
+            } else {
+                m_dirtyFiles.insert(path);
+            }
+        }
+    }
+#endif
+
+    void scan(bool notify)
+    {
+        if (isActive()) {
+            watchHeadRef();
+        }
+
+        git_status_options opts = GIT_STATUS_OPTIONS_INIT;
+        opts.show = GIT_STATUS_SHOW_INDEX_AND_WORKDIR;
+        opts.flags = GIT_STATUS_OPT_INCLUDE_UNTRACKED | GIT_STATUS_OPT_RECURSE_UNTRACKED_DIRS;
+
+        git_status_list *list = NULL;
+        qGitThrow(git_status_list_new(&list, m_repository.data(), &opts));
+        QHash<QString, unsigned int> statuses;
+        const size_t count = git_status_list_entrycount(list);
+        statuses.reserve(int(count));
+        for (size_t i = 0; i < count; ++i) {
+            const git_status_entry *entry = git_status_byindex(list, i);
+            const git_diff_delta *delta = entry->index_to_workdir ? entry->index_to_workdir : entry->head_to_index;
+            statuses.insert(PathCodec::fromLibGit2(delta->new_file.path), entry->status);
+        }
+        git_status_list_free(list);
+
+        m_statuses.swap(statuses);
+        m_dirtyFiles.clear();
+        m_dirtyDirectories.clear();
+        m_rescan = false;
+
+        if (notify) {
+            QSet<QString> changed;
+            for (QHash<QString, unsigned int>::const_iterator it = m_statuses.constBegin(); it != m_statuses.constEnd(); ++it) {
+                if (statuses.value(it.key()) != it.value()) {
+                    changed.insert(it.key());
+                }
+            }
+            for (QHash<QString, unsigned int>::const_iterator it = statuses.constBegin(); it != statuses.constEnd(); ++it) {
+                if (!m_statuses.contains(it.key())) {
+                    changed.insert(it.key());
+                }
+            }
+            foreach (const QString &path, changed) {
+                emit q_ptr->statusChanged(path);
+            }
+        }
+        emit q_ptr->rescanned();
+    }
+
+    void updateFile(const QString &path)
+    {
+        unsigned int flags = 0;
+        int error = git_status_file(&flags, m_repository.data(), PathCodec::toLibGit2(path).constData());
+        if (error == GIT_ENOTFOUND || error == GIT_EAMBIGUOUS) {
+            flags = GIT_STATUS_CURRENT;     // gone, or a directory
+        } else {
+            qGitThrow(error);
+        }
+        if (flags & GIT_STATUS_IGNORED) {
+            flags = GIT_STATUS_CURRENT;
+        }
+
+        if (flags == m_statuses.value(path, GIT_STATUS_CURRENT)) {
+            return;
+        }
+        if (flags == GIT_STATUS_CURRENT) {
+            m_statuses.remove(path);
+        } else {
+            m_statuses.insert(path, flags);
+        }
+        emit q_ptr->statusChanged(path);
+    }
+
+    /**
+     * Collects the files inside \a path that may have changed: those on disk, in the
+     * index, and with a known status. New subdirectories are watched.
+     */
+    void collectFiles(const QString &path, bool recursive, QSet<QString> &files)
+    {
+        QDir dir(joinPath(m_workDir, path));
+        if (dir.exists()) {
+            foreach (const QString &name, dir.entryList(QDir::Files | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot)) {
+                files.insert(joinPath(path, name));
+            }
+            foreach (const QString &name, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks)) {
+                const QString child = joinPath(path, name);
+                if ((recursive || !m_watches.contains(child)) && !isIgnoredDirectory(child)) {
+                    addWatch(child);
+                    collectFiles(child, true, files);
+                }
+            }
+        }
+
+        // the subdirectories that were removed, with everything inside
+        foreach (const QString &watched, m_watches.keys()) {
+            if (watched != path && isInside(watched, path, false) && !QDir(joinPath(m_workDir, watched)).exists()) {
+                foreach (const QString &inside, m_watches.keys()) {
+                    if (isInside(inside, watched, true)) {
+                        removeWatch(inside);
+                    }
+                }
+                removeWatch(watched);
+                collectKnownFiles(watched, true, files);
+            }
+        }
+
+        collectKnownFiles(path, recursive, files);
+    }
+
+    /** Collects the files inside \a path that are in the index or have a known status. */
+    void collectKnownFiles(const QString &path, bool recursive, QSet<QString> &files)
+    {
+        git_index *idx = NULL;
+        qGitThrow(git_repository_index(&idx, m_repository.data()));
+        QSharedPointer<git_index> index(idx, git_index_free);
+        qGitThrow(git_index_read(idx, 0));
+
+        const QByteArray prefix = path.isEmpty() ? QByteArray() : PathCodec::toLibGit2(path + QLatin1Char('/'));
+        size_t pos = 0;
+        if (git_index_find_prefix(&pos, idx, prefix.constData()) == 0) {
+            const size_t count = git_index_entrycount(idx);
+            for (; pos < count; ++pos) {
+                const char *entryPath = git_index_get_byindex(idx, pos)->path;
+                if (qstrncmp(entryPath, prefix.constData(), uint(prefix.size())) != 0) {
+                    break;
+                }
+                const QString file = PathCodec::fromLibGit2(entryPath);
+                if (isInside(file, path, recursive)) {
+                    files.insert(file);
+                }
+            }
+        }
+
+        for (QHash<QString, unsigned int>::const_iterator it = m_statuses.constBegin(); it != m_statuses.constEnd(); ++it) {
+            if (isInside(it.key(), path, recursive)) {
+                files.insert(it.key());
+            }
+        }
+    }
+
+    void process()
+    {
+        if (m_rescan) {
+            scan(true);
+            return;
+        }
+
+        QSet<QString> files;
+        files.swap(m_dirtyFiles);
+        QSet<QString> directories;
+        directories.swap(m_dirtyDirectories);
+
+        foreach (const QString &directory, directories) {
+            // with inotify a dirty directory was created, moved or removed; otherwise its content changed
+            const bool exists = QDir(joinPath(m_workDir, directory)).exists();
+            if (exists && isIgnoredDirectory(directory)) {
+                continue;
+            }
+            if (exists) {
+                addWatch(directory);
+            }
+            collectFiles(directory, m_inotify >= 0, files);
+        }
+        foreach (const QString &file, files) {
+            updateFile(file);
+        }
+    }
+
+    StatusWatcher *q_ptr;
+    Repository m_repository;
+    QString m_workDir;
+    QString m_gitDir;
+    QString m_commonDir;
+
+    /** The watched directory of the branch HEAD points to, and the name to look for in it. */
+    QString m_refDir;
+    QString m_refName;
+    int m_refWatch;
+
+    int m_inotify;
+    int m_gitWatch;
+    QSocketNotifier *m_notifier;
+    QFileSystemWatcher *m_watcher;
+
+    /** The watched directories, relative to the working directory, and their watch descriptors. */
+    QHash<QString, int> m_watches;
+    QHash<int, QString> m_directories;
+
+    /** The status of every file that is not current. */
+    QHash<QString, unsigned int> m_statuses;
+
+    QSet<QString> m_dirtyFiles;
+    QSet<QString> m_dirtyDirectories;
+    bool m_rescan;
+    QTimer m_timer;
+    QTimer m_pollTimer;
+};
+
+
+StatusWatcher::StatusWatcher(const Repository& repository, QObject *parent)
+    : QObject(parent),
+      d_ptr(new Private(this, repository))
+{
+    connect(&d_ptr->m_timer, &QTimer::timeout, this, &StatusWatcher::processPending);
+    connect(&d_ptr->m_pollTimer, &QTimer::timeout, this, &StatusWatcher::poll);
+}
+
+StatusWatcher::~StatusWatcher()
+{
+}
+
+void StatusWatcher::start()
+{
+    if (d_ptr->isActive()) {
+        return;
+    }
+    try {
+        d_ptr->open();
+        d_ptr->watchTree(QString());
+        d_ptr->scan(false);
+    } catch (...) {
+        d_ptr->close();
+        throw;
+    }
+}
+
+void StatusWatcher::stop()
+{
+    d_ptr->close();
+}
+
+bool StatusWatcher::isActive() const
+{
+    return d_ptr->isActive();
+}
+
+void StatusWatcher::setDebounceInterval(int msec)
+{
+    d_ptr->m_timer.setInterval(msec);
+}
+
+int StatusWatcher::debounceInterval() const
+{
+    return d_ptr->m_timer.interval();
+}
+
+Status StatusWatcher::status(const QString& path) const
+{
+    return Status(git_status_t(d_ptr->m_statuses.value(QDir::cleanPath(path), GIT_STATUS_CURRENT)));
+}
+
+QStringList StatusWatcher::changedPaths() const
+{
+    return d_ptr->m_statuses.keys();
+}
+
+void StatusWatcher::refresh()
+{
+    d_ptr->m_timer.stop();
+#ifdef Q_OS_LINUX
+    if (d_ptr->m_inotify >= 0) {
+        readEvents();
+        d_ptr->m_timer.stop();
+    }
+#endif
+    d_ptr->process();
+}
+
+void StatusWatcher::rescan()
+{
+    d_ptr->m_timer.stop();
+    d_ptr->scan(true);
+}
+
+void StatusWatcher::readEvents()
+{
+#ifdef Q_OS_LINUX
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t length;
+    while ((length = ::read(d_ptr->m_inotify, buffer, sizeof(buffer))) > 0) {
+        for (char *p = buffer; p < buffer + length; ) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event*>(p);
+            d_ptr->handleEvent(event->wd, event->mask, event->len ? QFile::decodeName(event->name) : QString());
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    d_ptr->schedule();
+#endif
+}
+
+void StatusWatcher::directoryChanged(const QString& path)
+{
+    if (QDir::cleanPath(path) == d_ptr->m_gitDir || QDir::cleanPath(path) == d_ptr->m_refDir) {
+        d_ptr->m_rescan = true;
+    } else {
+        d_ptr->m_dirtyDirectories.insert(d_ptr->relativePath(path));
+    }
+    d_ptr->schedule();
+}
+
+void StatusWatcher::processPending()
+{
+    try {
+        d_ptr->process();
+    } catch (const Exception &ex) {
+        emit error(QString::fromUtf8(ex.message()));
+    }
+}
+
+void StatusWatcher::poll()
+{
+    d_ptr->m_rescan = true;
+    processPending();
+}
+
+}
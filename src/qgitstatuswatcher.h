@@ -0,0 +1,149 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_STATUSWATCHER_H
+#define LIBQGIT2_STATUSWATCHER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QStringList>
+
+#include "qgitstatus.h"
+
+#include "libqgit2_export.h"
+
+namespace LibQGit2
+{
+    class Repository;
+
+    /**
+     * @brief Keeps the status of the files of a working directory up to date.
+     *
+     * start() runs one full status scan, like Repository::status() with untracked
+     * files, and starts watching the directories of the working directory, except
+     * the ignored ones. Afterwards only the files reported as changed by the file
+     * system are looked at again, each one with \c git_status_file(). Changes of the
+     * index, of HEAD, of the branch HEAD points to or of the packed refs trigger a new
+     * full scan. A directory that is renamed is watched under its new name.
+     *
+     * On Linux the directories are watched with inotify directly, which reports the
+     * modified files one by one. Elsewhere QFileSystemWatcher is used and all the
+     * files of a changed directory are looked at; whether modifications of existing
+     * files are noticed then depends on the platform.
+     *
+     * Events are collected for debounceInterval() milliseconds before they are
+     * handled, in the thread of the watcher. Renames are not detected.
+     *
+     * When a directory can not be watched, e.g. because the inotify watches of the
+     * user are exhausted, error() is emitted and full scans run every few seconds
+     * until the watcher is stopped.
+     *
+     * @ingroup LibQGit2
+     * @{
+     */
+    class LIBQGIT2_EXPORT StatusWatcher : public QObject
+    {
+            Q_OBJECT
+
+        public:
+            /**
+             * Creates a stopped watcher for the working directory of \a repository.
+             */
+            explicit StatusWatcher(const Repository& repository, QObject *parent = 0);
+
+            ~StatusWatcher();
+
+            /**
+             * Scans the working directory and starts watching it.
+             *
+             * @throws LibQGit2::Exception
+             */
+            void start();
+
+            /**
+             * Stops watching the working directory. The statuses are kept.
+             */
+            void stop();
+
+            bool isActive() const;
+
+            /**
+             * Sets the time to wait for more events before handling them, in milliseconds.
+             * The default is 50.
+             */
+            void setDebounceInterval(int msec);
+
+            int debounceInterval() const;
+
+            /**
+             * Returns the status of the file at \a path, relative to the working directory.
+             * Unmodified and ignored files are current.
+             */
+            Status status(const QString& path) const;
+
+            /**
+             * Returns the paths of the files that are not current, in no particular order.
+             */
+            QStringList changedPaths() const;
+
+            /**
+             * Handles the pending events right away.
+             *
+             * @throws LibQGit2::Exception
+             */
+            void refresh();
+
+            /**
+             * Runs a full status scan.
+             *
+             * @throws LibQGit2::Exception
+             */
+            void rescan();
+
+        signals:
+            /**
+             * The status of the file at \a path changed.
+             */
+            void statusChanged(const QString& path);
+
+            /**
+             * A full status scan was done.
+             */
+            void rescanned();
+
+            /**
+             * Handling the pending events failed; the statuses may be outdated.
+             */
+            void error(const QString& message);
+
+        private slots:
+            void readEvents();
+            void directoryChanged(const QString& path);
+            void processPending();
+            void poll();
+
+        private:
+            class Private;
+            QSharedPointer<Private> d_ptr;
+            Q_DECLARE_PRIVATE()
+    };
+
+    /**@}*/
+}
+
+#endif // LIBQGIT2_STATUSWATCHER_H
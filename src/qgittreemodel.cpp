@@ -0,0 +1,300 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "qgittreemodel.h"
+
+#include <QCache>
+#include <QVector>
+
+#include "qgitexception.h"
+#include "qgittree.h"
+#include "qgittreeentry.h"
+#include "private/pathcodec.h"
+
+namespace LibQGit2
+{
+
+namespace {
+    /** An entry of a tree shown by the model; the root node stands for the tree itself. */
+    struct Node {
+        Node(Node *parent, int row) :
+            parent(parent),
+            row(row),
+            mode(GIT_FILEMODE_TREE),
+            loaded(false)
+        {
+        }
+
+        ~Node()
+        {
+            qDeleteAll(children);
+        }
+
+        bool isTree() const
+        {
+            return mode == GIT_FILEMODE_TREE;
+        }
+
+        Node *parent;
+        int row;
+        QString name;
+        git_oid id;
+        quint32 mode;
+        bool loaded;
+        QVector<Node*> children;
+    };
+
+    Object::Type objectType(quint32 mode)
+    {
+        switch (mode) {
+        case GIT_FILEMODE_TREE:
+            return Object::TreeType;
+        case GIT_FILEMODE_COMMIT:
+            return Object::CommitType;
+        default:
+            return Object::BlobType;
+        }
+    }
+}
+
+class TreeModel::Private
+{
+public:
+    explicit Private(const Repository &repository) :
+        m_repository(repository),
+        m_trees(256),
+        m_root(new Node(0, 0)),
+        m_loadedTrees(0)
+    {
+    }
+
+    Tree lookupTree(const OId &oid)
+    {
+        if (Tree *tree = m_trees.object(oid)) {
+            return *tree;
+        }
+        Tree tree = m_repository.lookupTree(oid);
+        m_trees.insert(oid, new Tree(tree));
+        return tree;
+    }
+
+    /** Makes the children of \a node from the entries of \a tree. */
+    void load(Node *node, const Tree &tree)
+    {
+        const int count = int(git_tree_entrycount(tree.data()));
+        node->children.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            const git_tree_entry *entry = git_tree_entry_byindex(tree.data(), size_t(i));
+            Node *child = new Node(node, i);
+            child->name = PathCodec::fromLibGit2(git_tree_entry_name(entry));
+            git_oid_cpy(&child->id, git_tree_entry_id(entry));
+            child->mode = git_tree_entry_filemode(entry);
+            node->children.append(child);
+        }
+        node->loaded = true;
+        ++m_loadedTrees;
+    }
+
+    Node* node(const QModelIndex &index) const
+    {
+        return index.isValid() ? static_cast<Node*>(index.internalPointer()) : m_root.data();
+    }
+
+    Repository m_repository;
+    QCache<OId, Tree> m_trees;
+    QScopedPointer<Node> m_root;
+    int m_loadedTrees;
+};
+
+TreeModel::TreeModel(const Repository& repository, QObject *parent)
+    : QAbstractItemModel(parent)
+    , d_ptr(new Private(repository))
+{
+}
+
+TreeModel::~TreeModel()
+{
+}
+
+void TreeModel::setTree(const Tree& tree)
+{
+    if (tree.isNull()) {
+        beginResetModel();
+        d_ptr->m_root.reset(new Node(0, 0));
+        d_ptr->m_loadedTrees = 0;
+        endResetModel();
+        return;
+    }
+
+    const OId oid(git_tree_id(tree.data()));
+    if (!d_ptr->m_trees.contains(oid)) {
+        d_ptr->m_trees.insert(oid, new Tree(tree));
+    }
+
+    beginResetModel();
+    d_ptr->m_root.reset(new Node(0, 0));
+    git_oid_cpy(&d_ptr->m_root->id, oid.constData());
+    d_ptr->m_loadedTrees = 0;
+    d_ptr->load(d_ptr->m_root.data(), tree);
+    endResetModel();
+}
+
+int TreeModel::cacheSize() const
+{
+    return d_ptr->m_trees.maxCost();
+}
+
+void TreeModel::setCacheSize(int trees)
+{
+    d_ptr->m_trees.setMaxCost(trees);
+}
+
+int TreeModel::cachedTrees() const
+{
+    return d_ptr->m_trees.count();
+}
+
+int TreeModel::loadedTrees() const
+{
+    return d_ptr->m_loadedTrees;
+}
+
+OId TreeModel::id(const QModelIndex& index) const
+{
+    return index.isValid() ? OId(&d_ptr->node(index)->id) : OId();
+}
+
+QString TreeModel::path(const QModelIndex& index) const
+{
+    QString result;
+    for (const Node *node = d_ptr->node(index); node && node->parent; node = node->parent) {
+        result = node->parent->parent ? "/" + node->name + result : node->name + result;
+    }
+    return result;
+}
+
+QModelIndex TreeModel::index(int row, int column, const QModelIndex& parent) const
+{
+    const Node *node = d_ptr->node(parent);
+    if (column != 0 || row < 0 || row >= node->children.size()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column, node->children.at(row));
+}
+
+QModelIndex TreeModel::parent(const QModelIndex& index) const
+{
+    if (!index.isValid()) {
+        return QModelIndex();
+    }
+    const Node *parent = d_ptr->node(index)->parent;
+    if (parent == d_ptr->m_root.data()) {
+        return QModelIndex();
+    }
+    return createIndex(parent->row, 0, const_cast<Node*>(parent));
+}
+
+int TreeModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.column() > 0) {
+        return 0;
+    }
+    return d_ptr->node(parent)->children.size();
+}
+
+int TreeModel::columnCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+bool TreeModel::hasChildren(const QModelIndex& parent) const
+{
+    // subtrees that were not read yet are expandable, except for empty ones
+    const Node *node = d_ptr->node(parent);
+    return node->loaded ? !node->children.isEmpty() : node->isTree();
+}
+
+QVariant TreeModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.column() != 0) {
+        return QVariant();
+    }
+
+    const Node *node = d_ptr->node(index);
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return node->name;
+    case PathRole:
+        return path(index);
+    case IdRole:
+        return QString::fromLatin1(OId(&node->id).format());
+    case ModeRole:
+        return int(node->mode);
+    case TypeRole:
+        return int(objectType(node->mode));
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> TreeModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = QAbstractItemModel::roleNames();
+    roles.insert(NameRole, "name");
+    roles.insert(PathRole, "path");
+    roles.insert(IdRole, "id");
+    roles.insert(ModeRole, "mode");
+    roles.insert(TypeRole, "type");
+    return roles;
+}
+
+bool TreeModel::canFetchMore(const QModelIndex& parent) const
+{
+    const Node *node = d_ptr->node(parent);
+    return parent.isValid() && node->isTree() && !node->loaded;
+}
+
+void TreeModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    Node *node = d_ptr->node(parent);
+    Tree tree;
+    try {
+        tree = d_ptr->lookupTree(OId(&node->id));
+    } catch (const Exception &) {
+        // not asked again
+        node->loaded = true;
+        return;
+    }
+
+    const int count = int(git_tree_entrycount(tree.data()));
+    if (count == 0) {
+        d_ptr->load(node, tree);
+        return;
+    }
+    beginInsertRows(parent, 0, count - 1);
+    d_ptr->load(node, tree);
+    endInsertRows();
+}
+
+}
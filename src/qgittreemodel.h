@@ -0,0 +1,135 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LIBQGIT2_TREE_MODEL_H
+#define LIBQGIT2_TREE_MODEL_H
+
+#include "qgitoid.h"
+#include "qgitrepository.h"
+
+#include <QAbstractItemModel>
+#include <QSharedPointer>
+
+namespace LibQGit2
+{
+
+class Tree;
+
+/**
+ * @brief An item model of the entries of a tree and of its subtrees.
+ *
+ * Only the root tree is read when the model is set up. The entries of a subtree
+ * are read when a view expands it and calls fetchMore(), so browsing a large
+ * repository only reads the trees that are shown. The trees are looked up through
+ * a cache keyed by their id, which keeps the most recently used ones: identical
+ * subtrees at different places, and the trees shown again after setTree(), are
+ * not looked up twice.
+ *
+ * The entries are in the order of the tree. The model has a single column.
+ *
+ * @ingroup LibQGit2
+ * @{
+ */
+class LIBQGIT2_EXPORT TreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Role {
+        NameRole = Qt::UserRole + 1,    ///< the name of the entry, a QString; also the display role
+        PathRole,                       ///< the path of the entry from the root tree, a QString
+        IdRole,                         ///< the hexadecimal id of the object, a QString
+        ModeRole,                       ///< the file mode, a git_filemode_t value as an int
+        TypeRole                        ///< the Object::Type of the object, as an int
+    };
+
+    /**
+     * Creates an empty model of trees of \a repository.
+     */
+    explicit TreeModel(const Repository& repository, QObject *parent = 0);
+    ~TreeModel();
+
+    /**
+     * Shows the entries of \a tree, and resets the model.
+     *
+     * @throws LibQGit2::Exception
+     */
+    void setTree(const Tree& tree);
+
+    /**
+     * Returns the maximum number of trees kept in the cache; 256 by default.
+     */
+    int cacheSize() const;
+
+    /**
+     * Sets the maximum number of trees kept in the cache.
+     */
+    void setCacheSize(int trees);
+
+    /**
+     * Returns the number of trees in the cache.
+     */
+    int cachedTrees() const;
+
+    /**
+     * Returns the number of trees whose entries are rows of the model, the root
+     * tree included.
+     */
+    int loadedTrees() const;
+
+    /**
+     * Returns the id of the object of the entry at \a index, or an invalid OId.
+     */
+    OId id(const QModelIndex& index) const;
+
+    /**
+     * Returns the path of the entry at \a index from the root tree.
+     */
+    QString path(const QModelIndex& index) const;
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const;
+
+    QModelIndex parent(const QModelIndex& index) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+
+    int columnCount(const QModelIndex& parent = QModelIndex()) const;
+
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const;
+
+    QVariant data(const QModelIndex& index, int role) const;
+
+    QHash<int, QByteArray> roleNames() const;
+
+    bool canFetchMore(const QModelIndex& parent) const;
+
+    /**
+     * Reads the entries of the subtree at \a parent. A subtree that can not be read
+     * shows no entries.
+     */
+    void fetchMore(const QModelIndex& parent);
+
+private:
+    class Private;
+    QSharedPointer<Private> d_ptr;
+};
+
+/**@}*/
+}
+
+#endif // LIBQGIT2_TREE_MODEL_H
@@ -0,0 +1,165 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TestHelpers.h"
+
+#include "qgitblame.h"
+#include "qgitblamecache.h"
+#include "qgitcommit.h"
+#include "qgitindex.h"
+#include "qgitrepository.h"
+#include "qgitsignature.h"
+#include "qgittree.h"
+
+#include <QFile>
+
+
+using namespace LibQGit2;
+
+
+class TestBlame : public TestBase
+{
+    Q_OBJECT
+
+private slots:
+    void blameFile();
+    void incrementalCache();
+    void cacheAtHead();
+};
+
+
+namespace {
+/** Checks that both blames attribute every line to the same commit. */
+bool sameAttribution(const Blame &a, const Blame &b)
+{
+    if (a.lineCount() != b.lineCount()) {
+        return false;
+    }
+    for (size_t line = 1; line <= a.lineCount(); ++line) {
+        if (a.hunkForLine(line).finalCommitId() != b.hunkForLine(line).finalCommitId()) {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+
+void TestBlame::blameFile()
+{
+    Repository repo;
+    repo.open(ExistingRepository);
+
+    try {
+        Blame blame = repo.blameFile("CMakeLists.txt");
+        QVERIFY(!blame.isNull());
+        QVERIFY(blame.hunkCount() > 0);
+
+        size_t next = 1;
+        for (size_t i = 0; i < blame.hunkCount(); ++i) {
+            BlameHunk hunk = blame.hunk(i);
+            QCOMPARE(hunk.finalStartLine(), next);
+            QVERIFY(hunk.lineCount() > 0);
+            QVERIFY(hunk.finalCommitId().isValid());
+            QCOMPARE(blame.hunkForLine(next).finalStartLine(), next);
+            QCOMPARE(blame.hunkForLine(next + hunk.lineCount() - 1).finalStartLine(), next);
+            next += hunk.lineCount();
+        }
+        QCOMPARE(blame.lineCount(), next - 1);
+        QVERIFY(blame.hunkForLine(0).isNull());
+        QVERIFY(blame.hunkForLine(next).isNull());
+        QVERIFY(blame.hunk(blame.hunkCount()).isNull());
+
+        EXPECT_THROW(repo.blameFile("does/not/exist"), Exception);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestBlame::incrementalCache()
+{
+    Repository repo;
+    repo.open(ExistingRepository);
+
+    try {
+        Commit head = repo.lookupCommit(repo.head().target());
+        Commit older = head;
+        for (int i = 0; i < 4 && older.parentCount() > 0; ++i) {
+            older = older.parent(0);
+        }
+
+        BlameCache cache(repo);
+        Blame base = cache.blame("CHANGELOG.md", older.oid());
+        QVERIFY(sameAttribution(base, repo.blameFile("CHANGELOG.md", older.oid())));
+        QCOMPARE(cache.count(), 1);
+
+        // updated from the blame of the older commit
+        Blame updated = cache.blame("CHANGELOG.md", head.oid());
+        QVERIFY(sameAttribution(updated, repo.blameFile("CHANGELOG.md", head.oid())));
+        QCOMPARE(cache.count(), 2);
+
+        Blame again = cache.blame("CHANGELOG.md", head.oid());
+        QCOMPARE(again.hunkCount(), updated.hunkCount());
+        QCOMPARE(cache.count(), 2);
+
+        cache.clear();
+        QCOMPARE(cache.count(), 0);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestBlame::cacheAtHead()
+{
+    initTestRepo();
+
+    try {
+        Repository repo;
+        repo.open(testdir);
+
+        BlameCache cache(repo);
+        Blame before = cache.blame("CHANGELOG.md", OId());
+        QVERIFY(sameAttribution(before, repo.blameFile("CHANGELOG.md")));
+
+        // commit a new line, which moves HEAD
+        QFile file(testdir + "/CHANGELOG.md");
+        QVERIFY(file.open(QIODevice::Append));
+        QVERIFY(file.write("a line added at HEAD\n") > 0);
+        file.close();
+        Index index = repo.index();
+        index.addByPath("CHANGELOG.md");
+        index.write();
+        Commit parent = repo.lookupCommit(repo.head().target());
+        Signature signature("Tester", "tester@example.com");
+        const OId commit = repo.createCommit(repo.lookupTree(index.createTree()), QList<Commit>() << parent,
+                                             signature, signature, "add a line", "HEAD");
+
+        Blame after = cache.blame("CHANGELOG.md", OId());
+        QCOMPARE(after.lineCount(), before.lineCount() + 1);
+        QCOMPARE(after.hunkForLine(after.lineCount()).finalCommitId(), commit);
+        QVERIFY(sameAttribution(after, repo.blameFile("CHANGELOG.md")));
+        QVERIFY(sameAttribution(cache.blame("CHANGELOG.md", commit), after));
+        QCOMPARE(cache.count(), 2);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+QTEST_MAIN(TestBlame)
+
+#include "Blame.moc"
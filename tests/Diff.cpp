@@ -18,12 +18,24 @@
 * this software.
 */
 
+#include <QFile>
+
+#include <stdexcept>
+
 #include "TestHelpers.h"
 #include "qgitrepository.h"
+#include "qgitcommit.h"
+#include "qgitindex.h"
 #include "qgittree.h"
 #include "qgitdiff.h"
 #include "qgitdiffdelta.h"
 #include "qgitdifffile.h"
+#include "qgitdiffhunk.h"
+#include "qgitdiffline.h"
+#include "qgitdiffoptions.h"
+#include "qgitdiffpatch.h"
+#include "qgitdiffstats.h"
+#include "qgitrenameoptions.h"
 
 using namespace LibQGit2;
 
@@ -33,6 +45,12 @@ class TestDiff : public TestBase
 
 private slots:
     void testDiffFileList();
+    void testForEachAndPatches();
+    void testParallelPatches();
+    void testDiffOptions();
+    void testStats();
+    void testWorkdirDiffs();
+    void testFindRenames();
 };
 
 
@@ -57,6 +75,335 @@ void TestDiff::testDiffFileList()
     }
 }
 
+void TestDiff::testForEachAndPatches()
+{
+    Repository repo;
+    repo.open(ExistingRepository);
+
+    try {
+        Tree oldTree = repo.lookupRevision("HEAD~1^{tree}").toTree();
+        Tree newTree = repo.lookupRevision("HEAD^{tree}").toTree();
+        Diff diff = repo.diffTrees(oldTree, newTree);
+        QVERIFY(diff.numDeltas() > 0);
+
+        size_t files = 0, hunks = 0, additions = 0, deletions = 0;
+        bool numbered = true;
+        diff.forEach(
+            [&files](const DiffDelta &, float) { ++files; return true; },
+            [&hunks](const DiffDelta &, const DiffHunk &hunk) {
+                ++hunks;
+                return hunk.header().startsWith("@@");
+            },
+            [&additions, &deletions, &numbered](const DiffDelta &, const DiffHunk &, const DiffLine &line) {
+                if (line.origin() == DiffLine::Addition) {
+                    ++additions;
+                    numbered = numbered && line.newLineNumber() > 0;
+                } else if (line.origin() == DiffLine::Deletion) {
+                    ++deletions;
+                    numbered = numbered && line.oldLineNumber() > 0;
+                }
+                return true;
+            });
+        QCOMPARE(files, diff.numDeltas());
+        QVERIFY(numbered);
+
+        size_t patchHunks = 0, patchAdditions = 0, patchDeletions = 0;
+        for (size_t i = 0; i < diff.numDeltas(); ++i) {
+            DiffPatch patch = diff.patch(i);
+            if (patch.isNull()) {
+                continue;
+            }
+            QCOMPARE(patch.delta().newFile().path(), diff.delta(i).newFile().path());
+            size_t a = 0, r = 0;
+            patch.lineStats(0, &a, &r);
+            patchAdditions += a;
+            patchDeletions += r;
+            patchHunks += patch.numHunks();
+            if (patch.numHunks() > 0) {
+                QVERIFY(patch.numLines(0) > 0);
+                QVERIFY(!patch.line(0, 0).content().isEmpty());
+                QVERIFY(patch.toBuffer().contains(patch.hunk(0).header()));
+            }
+        }
+        QCOMPARE(patchHunks, hunks);
+        QCOMPARE(patchAdditions, additions);
+        QCOMPARE(patchDeletions, deletions);
+
+        // stopping early
+        files = 0;
+        diff.forEach([&files](const DiffDelta &, float) { ++files; return false; });
+        QCOMPARE(files, size_t(1));
+
+        EXPECT_THROW(diff.forEach([](const DiffDelta &, float) -> bool { throw Exception("stop"); }), Exception);
+        EXPECT_THROW(diff.forEach([](const DiffDelta &, float) -> bool { throw std::runtime_error("stop"); }), std::runtime_error);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestDiff::testParallelPatches()
+{
+    Repository repo;
+    repo.open(ExistingRepository);
+
+    try {
+        Tree oldTree = repo.lookupRevision("HEAD~3^{tree}").toTree();
+        Tree newTree = repo.lookupRevision("HEAD^{tree}").toTree();
+        Diff diff = repo.diffTrees(oldTree, newTree);
+
+        QVector<DiffPatch> patches = diff.generatePatchesParallel(repo, 3);
+        QCOMPARE(size_t(patches.size()), diff.numDeltas());
+        for (int i = 0; i < patches.size(); ++i) {
+            DiffPatch expected = diff.patch(i);
+            QCOMPARE(patches[i].isNull(), expected.isNull());
+            if (expected.isNull()) {
+                continue;
+            }
+            QCOMPARE(patches[i].delta().newFile().path(), diff.delta(i).newFile().path());
+            QCOMPARE(patches[i].numHunks(), expected.numHunks());
+            QCOMPARE(patches[i].toBuffer(), expected.toBuffer());
+        }
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+
+    // the working directory side is hashed, or not, but never in the object database
+    initTestRepo();
+
+    try {
+        Repository workRepo;
+        workRepo.open(testdir);
+
+        QFile sameSize(testdir + "/README.md");
+        QVERIFY(sameSize.open(QIODevice::ReadWrite));
+        QByteArray content = sameSize.readAll();
+        QVERIFY(!content.isEmpty());
+        content[0] = content.at(0) == 'x' ? 'y' : 'x';
+        QVERIFY(sameSize.seek(0));
+        QCOMPARE(sameSize.write(content), qint64(content.size()));
+        sameSize.close();
+
+        QFile resized(testdir + "/CMakeLists.txt");
+        QVERIFY(resized.open(QIODevice::Append));
+        resized.write("# modified\n");
+        resized.close();
+
+        Diff diff = workRepo.diffIndexToWorkdir();
+        QCOMPARE(diff.numDeltas(), size_t(2));
+        QVector<DiffPatch> patches = diff.generatePatchesParallel(workRepo, 2);
+        QCOMPARE(size_t(patches.size()), diff.numDeltas());
+        for (int i = 0; i < patches.size(); ++i) {
+            DiffPatch expected = diff.patch(i);
+            QVERIFY(!expected.isNull());
+            QCOMPARE(patches[i].toBuffer(), expected.toBuffer());
+        }
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestDiff::testDiffOptions()
+{
+    Repository repo;
+    repo.open(ExistingRepository);
+
+    try {
+        Tree oldTree = repo.lookupRevision("HEAD~3^{tree}").toTree();
+        Tree newTree = repo.lookupRevision("HEAD^{tree}").toTree();
+
+        DiffOptions srcOnly;
+        srcOnly.setPaths(QList<QString>() << "src");
+        Diff all = repo.diffTrees(oldTree, newTree);
+        Diff src = repo.diffTrees(oldTree, newTree, srcOnly);
+        QVERIFY(src.numDeltas() <= all.numDeltas());
+        for (size_t i = 0; i < src.numDeltas(); ++i) {
+            QVERIFY(src.delta(i).newFile().path().startsWith("src/"));
+        }
+
+        DiffOptions noContext(DiffOptions::SkipBinaryCheck);
+        noContext.setContextLines(0);
+        QVERIFY(noContext.flags().testFlag(DiffOptions::SkipBinaryCheck));
+        QVERIFY(!noContext.findsSimilar());
+        QVERIFY(!noContext.findData());
+        Diff diff = repo.diffTrees(oldTree, newTree, noContext);
+        QVector<DiffPatch> patches = diff.generatePatchesParallel(repo, 2);
+        for (int i = 0; i < patches.size(); ++i) {
+            DiffPatch expected = diff.patch(i);
+            if (expected.isNull()) {
+                continue;
+            }
+            QCOMPARE(patches[i].toBuffer(), expected.toBuffer());
+            for (size_t h = 0; h < expected.numHunks(); ++h) {
+                for (int l = 0; l < expected.numLines(h); ++l) {
+                    QVERIFY(expected.line(h, size_t(l)).origin() != DiffLine::Context);
+                }
+            }
+        }
+
+        DiffOptions reverse(DiffOptions::Reverse);
+        Diff reversed = repo.diffTrees(oldTree, newTree, reverse);
+        QCOMPARE(reversed.numDeltas(), all.numDeltas());
+        patches = reversed.generatePatchesParallel(repo, 2);
+        for (int i = 0; i < patches.size(); ++i) {
+            DiffPatch expected = reversed.patch(i);
+            if (expected.isNull()) {
+                continue;
+            }
+            QCOMPARE(patches[i].toBuffer(), expected.toBuffer());
+        }
+
+        DiffOptions renames;
+        renames.setRenameThreshold(60);
+        QVERIFY(renames.findsSimilar());
+        QCOMPARE(renames.findData()->rename_threshold, quint16(60));
+        QVERIFY(repo.diffTrees(oldTree, newTree, renames).numDeltas() <= all.numDeltas());
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestDiff::testStats()
+{
+    Repository repo;
+    repo.open(ExistingRepository);
+
+    try {
+        Commit head = repo.lookupCommit(repo.head().target());
+        Diff diff = repo.diffTrees(head.parent(0).tree(), head.tree());
+
+        DiffStats stats = diff.stats();
+        QCOMPARE(stats.filesChanged(), diff.numDeltas());
+        size_t insertions = 0, deletions = 0;
+        for (size_t i = 0; i < diff.numDeltas(); ++i) {
+            size_t a = 0, r = 0;
+            DiffPatch patch = diff.patch(i);
+            if (!patch.isNull()) {
+                patch.lineStats(0, &a, &r);
+            }
+            QCOMPARE(stats.insertions(i), a);
+            QCOMPARE(stats.deletions(i), r);
+            QCOMPARE(stats.path(i), diff.delta(i).newFile().path());
+            insertions += a;
+            deletions += r;
+        }
+        QCOMPARE(stats.insertions(), insertions);
+        QCOMPARE(stats.deletions(), deletions);
+
+        QVector<OId> commits;
+        commits << head.oid() << head.parentId(0) << head.oid();
+        QVector<DiffStats> batch = repo.diffStatsForCommits(commits);
+        QCOMPARE(batch.size(), 3);
+        QCOMPARE(batch[0].insertions(), stats.insertions());
+        QCOMPARE(batch[0].deletions(), stats.deletions());
+        QCOMPARE(batch[2].filesChanged(), stats.filesChanged());
+
+        Commit parent = head.parent(0);
+        DiffStats parentStats = repo.diffTrees(parent.parentCount() ? parent.parent(0).tree() : Tree(), parent.tree()).stats();
+        QCOMPARE(batch[1].filesChanged(), parentStats.filesChanged());
+        QCOMPARE(batch[1].insertions(), parentStats.insertions());
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+namespace {
+bool containsPath(const Diff &diff, const QString &path, DiffDelta::Type type)
+{
+    for (size_t i = 0; i < diff.numDeltas(); ++i) {
+        if (diff.delta(i).newFile().path() == path) {
+            return diff.delta(i).type() == type;
+        }
+    }
+    return false;
+}
+}
+
+void TestDiff::testWorkdirDiffs()
+{
+    initTestRepo();
+
+    try {
+        Repository repo;
+        repo.open(testdir);
+        Tree head = repo.lookupCommit(repo.head().target()).tree();
+
+        QVERIFY(repo.diffIndexToWorkdir().numDeltas() == 0);
+        QVERIFY(repo.diffTreeToIndex(head).numDeltas() == 0);
+
+        QFile modified(testdir + "/CMakeLists.txt");
+        QVERIFY(modified.open(QIODevice::Append));
+        modified.write("# modified\n");
+        modified.close();
+
+        QFile untracked(testdir + "/untracked.txt");
+        QVERIFY(untracked.open(QIODevice::WriteOnly));
+        untracked.write("untracked\n");
+        untracked.close();
+
+        DiffOptions opts(DiffOptions::IncludeUntracked | DiffOptions::UpdateIndex);
+        Diff workdir = repo.diffIndexToWorkdir(Index(), opts);
+        QVERIFY(containsPath(workdir, "CMakeLists.txt", DiffDelta::Modified));
+        QVERIFY(containsPath(workdir, "untracked.txt", DiffDelta::Untracked));
+        QVERIFY(!containsPath(repo.diffIndexToWorkdir(), "untracked.txt", DiffDelta::Untracked));
+
+        // a second refresh sees the same changes
+        QCOMPARE(repo.diffIndexToWorkdir(Index(), opts).numDeltas(), workdir.numDeltas());
+
+        Index index = repo.index();
+        index.addByPath("CMakeLists.txt");
+        index.write();
+        QVERIFY(containsPath(repo.diffTreeToIndex(head), "CMakeLists.txt", DiffDelta::Modified));
+        QVERIFY(!containsPath(repo.diffIndexToWorkdir(), "CMakeLists.txt", DiffDelta::Modified));
+        QVERIFY(containsPath(repo.diffTreeToWorkdirWithIndex(head), "CMakeLists.txt", DiffDelta::Modified));
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestDiff::testFindRenames()
+{
+    initTestRepo();
+
+    try {
+        Repository repo;
+        repo.open(testdir);
+        Tree head = repo.lookupCommit(repo.head().target()).tree();
+
+        QFile::rename(testdir + "/CMakeLists.txt", testdir + "/Renamed.txt");
+        QFile renamed(testdir + "/Renamed.txt");
+        QVERIFY(renamed.open(QIODevice::Append));
+        renamed.write("# modified\n");
+        renamed.close();
+
+        Index index = repo.index();
+        index.remove("CMakeLists.txt", 0);
+        index.addByPath("Renamed.txt");
+        index.write();
+
+        Diff diff = repo.diffTreeToIndex(head);
+        QVERIFY(containsPath(diff, "Renamed.txt", DiffDelta::Added));
+
+        RenameOptions opts;
+        opts.setCandidateLimit(100);
+        diff.findRenames(opts);
+        QVERIFY(containsPath(diff, "Renamed.txt", DiffDelta::Renamed));
+        QVERIFY(!containsPath(diff, "CMakeLists.txt", DiffDelta::Deleted));
+        QCOMPARE(opts.cachedSignatures(), 2);
+
+        // the signatures are reused by the next diff
+        Diff again = repo.diffTreeToIndex(head);
+        again.findRenames(opts);
+        QVERIFY(containsPath(again, "Renamed.txt", DiffDelta::Renamed));
+        QCOMPARE(opts.cachedSignatures(), 2);
+
+        Diff exact = repo.diffTreeToIndex(head);
+        exact.findRenames(RenameOptions(RenameOptions::FindRenames | RenameOptions::ExactMatchOnly));
+        QVERIFY(containsPath(exact, "Renamed.txt", DiffDelta::Added));
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
 QTEST_MAIN(TestDiff)
 
 #include "Diff.moc"
@@ -0,0 +1,384 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TestHelpers.h"
+
+#include <QDir>
+#include <QFile>
+#include <QMap>
+#include <QPair>
+#include <QProcess>
+#include <QSignalSpy>
+
+#include <stdexcept>
+
+#include "qgitindex.h"
+#include "qgitindexentry.h"
+#include "qgitindexmodel.h"
+#include "qgitindexview.h"
+#include "qgitrepository.h"
+#include "qgitstatuslist.h"
+#include "qgitstatusoptions.h"
+
+
+using namespace LibQGit2;
+
+
+class TestIndex : public TestBase
+{
+    Q_OBJECT
+
+private slots:
+    void addAll();
+    void view();
+    void splitIndex();
+    void model();
+};
+
+
+namespace {
+bool writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+    return file.write(data) == data.size();
+}
+
+bool runGit(const QString &dir, const QStringList &args)
+{
+    QProcess git;
+    git.setWorkingDirectory(dir);
+    git.start("git", args);
+    return git.waitForFinished() && git.exitStatus() == QProcess::NormalExit && git.exitCode() == 0;
+}
+
+QList<QPair<QString, OId> > entries(const IndexView &view)
+{
+    QList<QPair<QString, OId> > result;
+    IndexView::Cursor cursor = view.cursor();
+    while (cursor.next()) {
+        result.append(qMakePair(cursor.entry().path(), cursor.entry().id()));
+    }
+    return result;
+}
+
+bool sameRows(const IndexModel &model, const Index &index)
+{
+    if (unsigned(model.rowCount(QModelIndex())) != index.entryCount()) {
+        return false;
+    }
+    for (int i = 0; i < model.rowCount(QModelIndex()); ++i) {
+        const IndexEntry entry = index.getByIndex(i);
+        if (model.data(model.index(i), IndexModel::PathRole).toString() != entry.path() || model.id(i) != entry.id() ||
+            model.data(model.index(i), IndexModel::FileSizeRole).toLongLong() != entry.fileSize()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QMap<QString, OId> entries(const Index &index)
+{
+    QMap<QString, OId> result;
+    for (unsigned int i = 0; i < index.entryCount(); ++i) {
+        const IndexEntry entry = index.getByIndex(int(i));
+        result.insert(entry.path(), entry.id());
+    }
+    return result;
+}
+}
+
+
+void TestIndex::addAll()
+{
+    initTestRepo();
+
+    try {
+        Repository repo;
+        repo.open(testdir);
+
+        QVERIFY(QDir(testdir).mkpath("bulk/sub"));
+        for (int i = 0; i < 300; ++i) {
+            QVERIFY(writeFile(QString("%1/bulk/%2/file%3.txt").arg(testdir).arg(i % 2 ? "sub" : ".").arg(i),
+                              QByteArray::number(i) + "\n"));
+        }
+        QVERIFY(writeFile(testdir + "/CMakeLists.txt", "# modified\n"));
+        QVERIFY(writeFile(testdir + "/skipped.txt", "skipped\n"));
+
+        const Index::MatchCallback skip = [](const QString &path, const QString &) {
+            return path == "skipped.txt" ? 1 : 0;
+        };
+
+        Index index = repo.index();
+        const unsigned int before = index.entryCount();
+        index.addAllParallel(QStringList(), Index::AddDefault, skip, 4);
+        QCOMPARE(index.entryCount(), before + 300);
+        QVERIFY(index.find("skipped.txt") < 0);
+        const QMap<QString, OId> parallel = entries(index);
+
+        index.read(true);
+        QCOMPARE(index.entryCount(), before);
+        index.addAll(QStringList(), Index::AddDefault, skip);
+        QCOMPARE(entries(index), parallel);
+
+        index.write();
+        StatusList status = repo.status(StatusOptions(StatusOptions::ShowIndexAndWorkdir, StatusOptions::IncludeUntracked));
+        size_t workdirChanges = 0;
+        for (size_t i = 0; i < status.entryCount(); ++i) {
+            if (status.entryByIndex(i).status().isNewInWorkdir() || status.entryByIndex(i).status().isModifiedInWorkdir()) {
+                QCOMPARE(status.entryByIndex(i).indexToWorkdir().newFile().path(), QString("skipped.txt"));
+                ++workdirChanges;
+            }
+        }
+        QCOMPARE(workdirChanges, size_t(1));
+
+        // a pathspec limits the files, and a negative result stops
+        QVERIFY(writeFile(testdir + "/bulk/file0.txt", "changed\n"));
+        QVERIFY(writeFile(testdir + "/README.md", "changed\n"));
+        const OId readme = index.getByIndex(index.find("README.md")).id();
+        index.addAllParallel(QStringList() << "bulk", Index::AddDefault, Index::MatchCallback(), 2);
+        QVERIFY(index.getByIndex(index.find("bulk/file0.txt")).id() != parallel.value("bulk/file0.txt"));
+        QCOMPARE(index.getByIndex(index.find("README.md")).id(), readme);
+
+        index.addAll(QStringList(), Index::AddDefault, [](const QString &, const QString &) { return -1; });
+        QCOMPARE(index.getByIndex(index.find("README.md")).id(), readme);
+        EXPECT_THROW(index.addAll(QStringList(), Index::AddDefault,
+                                  [](const QString &, const QString &) -> int { throw std::runtime_error("stop"); }),
+                     std::runtime_error);
+        index.updateAll(QStringList() << "README.md");
+        QVERIFY(index.getByIndex(index.find("README.md")).id() != readme);
+
+        // the entries of deleted files are removed, and modes follow core.filemode
+        index.write();
+        QVERIFY(QFile::remove(testdir + "/bulk/file2.txt"));
+        const QString script = testdir + "/bulk/sub/file1.txt";
+        QVERIFY(QFile::setPermissions(script, QFile::permissions(script) | QFile::ExeOwner));
+        index.addAllParallel(QStringList() << "bulk", Index::AddDefault, Index::MatchCallback(), 2);
+        QVERIFY(index.find("bulk/file2.txt") < 0);
+#ifdef Q_OS_UNIX
+        QCOMPARE(quint32(index.getByIndex(index.find("bulk/sub/file1.txt")).data()->mode), quint32(GIT_FILEMODE_BLOB_EXECUTABLE));
+#endif
+        const QMap<QString, OId> withDeletion = entries(index);
+        index.read(true);
+        index.addAll(QStringList() << "bulk");
+        QCOMPARE(entries(index), withDeletion);
+        index.write();
+
+        git_config *config = 0;
+        qGitThrow(git_repository_config(&config, repo.data()));
+        qGitThrow(git_config_set_bool(config, "core.filemode", 0));
+        git_config_free(config);
+        qGitThrow(git_index_set_caps(index.data(), GIT_INDEX_CAPABILITY_FROM_OWNER));
+        const quint32 mode = index.getByIndex(index.find("bulk/sub/file1.txt")).data()->mode;
+        QVERIFY(QFile::setPermissions(script, QFile::permissions(script) & ~(QFile::ExeOwner | QFile::ExeUser)));
+        QVERIFY(writeFile(script, "changed, but still executable\n"));
+        index.addAllParallel(QStringList() << "bulk", Index::AddDefault, Index::MatchCallback(), 2);
+        QCOMPARE(quint32(index.getByIndex(index.find("bulk/sub/file1.txt")).data()->mode), mode);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestIndex::view()
+{
+    initTestRepo();
+
+    try {
+        Repository repo;
+        repo.open(testdir);
+        Index index = repo.index();
+
+        IndexView closed;
+        QVERIFY(!closed.isOpen());
+        QCOMPARE(closed.count(), 0);
+        QVERIFY(!closed.cursor().next());
+        QVERIFY(!closed.open(testdir + "/README.md"));
+
+        foreach (unsigned int version, QList<unsigned int>() << 2 << 4) {
+            qGitThrow(git_index_set_version(index.data(), version));
+            index.write();
+
+            IndexView view;
+            QVERIFY(view.open(IndexView::defaultPath(repo)));
+            QCOMPARE(view.version(), int(version));
+            QVERIFY(!view.isSplit());
+            QCOMPARE(unsigned(view.count()), index.entryCount());
+
+            IndexView::Cursor cursor = view.cursor();
+            for (int i = 0; i < view.count(); ++i) {
+                QVERIFY(cursor.next());
+                QCOMPARE(cursor.position(), i);
+
+                const IndexEntry expected = index.getByIndex(i);
+                QCOMPARE(cursor.entry().path(), expected.path());
+                QCOMPARE(cursor.entry().id(), expected.id());
+                QCOMPARE(qint64(cursor.entry().fileSize()), expected.fileSize());
+                QCOMPARE(cursor.entry().mode(), quint32(expected.data()->mode));
+                QCOMPARE(cursor.entry().stage(), expected.stage());
+            }
+            QVERIFY(!cursor.next());
+
+            // random access, in the other direction
+            for (int i = view.count() - 1; i >= 0; --i) {
+                const IndexView::Entry entry = view.entry(i);
+                QCOMPARE(entry.path(), index.getByIndex(i).path());
+                QCOMPARE(view.find(entry.rawPath()), i);
+            }
+            QVERIFY(!view.entry(view.count()).isValid());
+            QCOMPARE(view.find("no/such/file"), -1);
+            QCOMPARE(view.find("README.md", 2), -1);
+
+            // entries outlive the cursor moving on and the view being closed
+            IndexView::Cursor again = view.cursor();
+            QVERIFY(again.next());
+            const IndexView::Entry first = again.entry();
+            QVERIFY(again.next());
+            view.close();
+            QCOMPARE(first.path(), index.getByIndex(0).path());
+            QCOMPARE(first.id(), index.getByIndex(0).id());
+            QCOMPARE(again.entry().path(), index.getByIndex(1).path());
+        }
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestIndex::splitIndex()
+{
+    initTestRepo();
+    if (!runGit(testdir, QStringList() << "--version")) {
+        SKIPTEST("git is needed to write a split index");
+    }
+
+    try {
+        // an entry of each kind: replaced, deleted and new
+        QVERIFY(runGit(testdir, QStringList() << "update-index" << "--split-index"));
+        QVERIFY(writeFile(testdir + "/README.md", "changed\n"));
+        QVERIFY(writeFile(testdir + "/new.txt", "new\n"));
+        QVERIFY(runGit(testdir, QStringList() << "add" << "README.md" << "new.txt"));
+        QVERIFY(runGit(testdir, QStringList() << "rm" << "-q" << "--cached" << "CHANGELOG.md"));
+        QVERIFY(runGit(testdir, QStringList() << "update-index" << "--untracked-cache"));
+
+        IndexView split;
+        QVERIFY(split.open(testdir + "/.git/index"));
+        QVERIFY(split.isSplit());
+        QVERIFY(split.sharedIndexId().isValid());
+        QVERIFY(split.extensions().contains("link"));
+        QVERIFY(split.hasUntrackedCache());
+        QVERIFY(split.find("new.txt") >= 0);
+        QCOMPARE(split.find("CHANGELOG.md"), -1);
+        const QList<QPair<QString, OId> > splitEntries = entries(split);
+        QCOMPARE(splitEntries.size(), split.count());
+        for (int i = 0; i < split.count(); ++i) {
+            QCOMPARE(split.entry(i).path(), splitEntries.at(i).first);
+        }
+
+        QVERIFY(runGit(testdir, QStringList() << "update-index" << "--no-split-index"));
+        IndexView full;
+        QVERIFY(full.open(testdir + "/.git/index"));
+        QVERIFY(!full.isSplit());
+        QVERIFY(!full.sharedIndexId().isValid());
+        QCOMPARE(entries(full), splitEntries);
+
+        Repository repo;
+        repo.open(testdir);
+        QCOMPARE(splitEntries.at(full.find("README.md")).second, repo.index().getByIndex(repo.index().find("README.md")).id());
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestIndex::model()
+{
+    initTestRepo();
+
+    try {
+        Repository repo;
+        repo.open(testdir);
+
+        QVERIFY(QDir(testdir).mkpath("many"));
+        for (int i = 0; i < 1500; ++i) {
+            QVERIFY(writeFile(QString("%1/many/%2.txt").arg(testdir).arg(i, 4, 10, QChar('0')), QByteArray::number(i)));
+        }
+        Index index = repo.index();
+        index.addAllParallel(QStringList() << "many");
+
+        IndexModel model(index);
+        QCOMPARE(model.rowCount(QModelIndex()), model.batchSize());
+        QVERIFY(model.canFetchMore(QModelIndex()));
+        QSignalSpy inserted(&model, &IndexModel::rowsInserted);
+        QSignalSpy removed(&model, &IndexModel::rowsRemoved);
+        QSignalSpy changed(&model, &IndexModel::dataChanged);
+        while (model.canFetchMore(QModelIndex())) {
+            model.fetchMore(QModelIndex());
+        }
+        QVERIFY(sameRows(model, index));
+        QVERIFY(inserted.count() > 0);
+        inserted.clear();
+
+        // one entry of each kind of change
+        index.remove("README.md", 0);
+        QVERIFY(writeFile(testdir + "/CMakeLists.txt", "# modified\n"));
+        index.addByPath("CMakeLists.txt");
+        QVERIFY(writeFile(testdir + "/added.txt", "added\n"));
+        index.addByPath("added.txt");
+        model.refresh();
+        QVERIFY(sameRows(model, index));
+        QCOMPARE(inserted.count(), 1);
+        QCOMPARE(removed.count(), 1);
+        QCOMPARE(changed.count(), 1);
+        const int row = index.find("CMakeLists.txt");
+        QCOMPARE(changed.at(0).at(0).value<QModelIndex>().row(), row);
+        QCOMPARE(model.data(model.index(row), IndexModel::IdRole).toString(), QString::fromLatin1(index.getByIndex(row).id().format()));
+        QVERIFY(!model.canFetchMore(QModelIndex()));
+
+        // the entries after the rows read so far are left to fetchMore()
+        IndexModel partial(index);
+        const int rows = partial.rowCount(QModelIndex());
+        QVERIFY(writeFile(testdir + "/zzz.txt", "last\n"));
+        index.addByPath("zzz.txt");
+        partial.refresh();
+        QCOMPARE(partial.rowCount(QModelIndex()), rows);
+        while (partial.canFetchMore(QModelIndex())) {
+            partial.fetchMore(QModelIndex());
+        }
+        QVERIFY(sameRows(partial, index));
+
+        // the index shrinks below the rows read so far without a refresh()
+        IndexModel shrunk(index);
+        shrunk.setBatchSize(100);
+        QCOMPARE(shrunk.rowCount(QModelIndex()), 1024);
+        shrunk.fetchMore(QModelIndex());
+        for (int i = 0; i < 1500; ++i) {
+            index.remove(QString("many/%1.txt").arg(i, 4, 10, QChar('0')), 0);
+        }
+        QVERIFY(int(index.entryCount()) < shrunk.rowCount(QModelIndex()));
+        while (shrunk.canFetchMore(QModelIndex())) {
+            shrunk.fetchMore(QModelIndex());
+        }
+        QVERIFY(sameRows(shrunk, index));
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+QTEST_MAIN(TestIndex)
+
+#include "Index.moc"
@@ -0,0 +1,149 @@
+#include "TestHelpers.h"
+
+#include "qgitoid.h"
+#include "qgitoidmap.h"
+#include "qgitoidset.h"
+
+#include <QHash>
+
+#include <unordered_set>
+
+
+using namespace LibQGit2;
+
+
+class TestOId : public TestBase
+{
+    Q_OBJECT
+
+private slots:
+    void fromHex();
+    void rawData();
+    void validity();
+    void compare();
+    void map();
+    void set();
+};
+
+
+void TestOId::fromHex()
+{
+    try {
+        const QByteArray hex("127c9e7d17a6b2d5e8f5ab3c83ee2f0aa6c4f1c2");
+        OId oid = OId::stringToOid(hex);
+        QCOMPARE(oid.length(), 40);
+        QVERIFY(oid.isFull());
+        QCOMPARE(oid.format(), hex);
+        QCOMPARE(oid.pathFormat(), QByteArray("12/7c9e7d17a6b2d5e8f5ab3c83ee2f0aa6c4f1c2"));
+
+        OId prefix = OId::stringToOid("127c9e7");
+        QCOMPARE(prefix.length(), 7);
+        QVERIFY(!prefix.isFull());
+        QCOMPARE(prefix.format(), QByteArray("127c9e7000000000000000000000000000000000"));
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestOId::rawData()
+{
+    QByteArray raw(GIT_OID_RAWSZ, Qt::Uninitialized);
+    for (int i = 0; i < raw.size(); ++i) {
+        raw[i] = char(i + 1);
+    }
+
+    OId oid = OId::rawDataToOid(raw);
+    QCOMPARE(oid.length(), 40);
+    QCOMPARE(QByteArray(reinterpret_cast<const char*>(oid.constData()->id), GIT_OID_RAWSZ), raw);
+
+    OId copy(oid.constData());
+    QCOMPARE(copy, oid);
+}
+
+void TestOId::validity()
+{
+    QVERIFY(!OId().isValid());
+    QVERIFY(!OId::rawDataToOid(QByteArray()).isValid());
+    QVERIFY(OId::stringToOid("0000000000000000000000000000000000000001").isValid());
+}
+
+void TestOId::compare()
+{
+    OId a = OId::stringToOid("1000000000000000000000000000000000000000");
+    OId b = OId::stringToOid("2000000000000000000000000000000000000000");
+    QVERIFY(a < b);
+    QVERIFY(!(b < a));
+    QVERIFY(a != b);
+
+    OId moved(std::move(b));
+    QCOMPARE(moved, OId::stringToOid("2000000000000000000000000000000000000000"));
+
+    QHash<OId, int> hash;
+    hash.insert(a, 1);
+    hash.insert(moved, 2);
+    QCOMPARE(hash.value(a), 1);
+    QCOMPARE(hash.value(moved), 2);
+}
+
+static OId numberedOId(int n)
+{
+    // spread the numbers over the leading bytes, which the hash uses
+    QByteArray raw(GIT_OID_RAWSZ, '\0');
+    for (int i = 0; i < 4; ++i) {
+        raw[i] = char((n >> (8 * i)) & 0xff);
+        raw[GIT_OID_RAWSZ - 1 - i] = raw[i];
+    }
+    return OId::rawDataToOid(raw);
+}
+
+void TestOId::map()
+{
+    OIdMap<int> map;
+    QVERIFY(map.isEmpty());
+    QVERIFY(!map.contains(numberedOId(1)));
+
+    const int count = 10000;
+    for (int i = 0; i < count; ++i) {
+        QVERIFY(map.insert(numberedOId(i), i));
+    }
+    QCOMPARE(map.size(), count);
+    QVERIFY(!map.insert(numberedOId(42), -42));
+    QCOMPARE(map.size(), count);
+    QCOMPARE(map.value(numberedOId(42)), -42);
+
+    for (int i = 0; i < count; i += 2) {
+        QVERIFY(map.remove(numberedOId(i)));
+    }
+    QCOMPARE(map.size(), count / 2);
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(map.contains(numberedOId(i)), i % 2 == 1);
+    }
+    QVERIFY(!map.find(numberedOId(count)));
+
+    map[numberedOId(count)] += 5;
+    QCOMPARE(*map.find(numberedOId(count)), 5);
+
+    int sum = 0;
+    map.forEach([&sum](const OId&, int value) { sum += value; });
+    QCOMPARE(sum, 25000000 + 5);
+}
+
+void TestOId::set()
+{
+    OIdSet set;
+    set.reserve(1000);
+    const int capacity = set.capacity();
+
+    std::unordered_set<OId> reference;
+    for (int i = 0; i < 1000; ++i) {
+        OId oid = numberedOId(i % 700);
+        QCOMPARE(set.insert(oid), reference.insert(oid).second);
+    }
+    QCOMPARE(set.size(), 700);
+    QCOMPARE(set.capacity(), capacity);
+    QCOMPARE(set.values().size(), 700);
+}
+
+QTEST_MAIN(TestOId);
+
+#include "OId.moc"
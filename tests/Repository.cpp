@@ -21,7 +21,11 @@
 #include "TestHelpers.h"
 
 #include "qgitrepository.h"
+#include "qgitblob.h"
+#include "qgitblobreader.h"
+#include "qgitblobwriter.h"
 #include "qgitremote.h"
+#include "qgitrevwalk.h"
 
 #include <QPointer>
 #include <QDir>
@@ -46,6 +50,9 @@ private slots:
     void testDeleteBranch();
     void testShouldIgnore();
     void testIdentitySetting();
+    void testLookupMany();
+    void testBlobStreams();
+    void testBlobContentView();
 
 private:
     const QString branchName;
@@ -155,6 +162,97 @@ void TestRepository::testIdentitySetting()
     QCOMPARE(repo->identity(), id);
 }
 
+void TestRepository::testLookupMany()
+{
+    repo->open(ExistingRepository);
+
+    RevWalk rw(*repo);
+    rw.pushHead();
+    QVector<OId> oids;
+    Commit commit;
+    while (rw.next(commit)) {
+        oids << commit.oid() << commit.tree().oid();
+    }
+    QVERIFY(oids.size() > 2);
+
+    QVector<OId> found;
+    repo->lookupMany(oids, [&found](const Object &object) {
+        QVERIFY(object.isCommit() || object.isTree());
+        found << object.oid();
+    }, 3);
+    QCOMPARE(found.size(), oids.size());
+    foreach (const OId &oid, oids) {
+        QVERIFY(found.contains(oid));
+    }
+
+    oids << OId::stringToOid("0123456789012345678901234567890123456789");
+    EXPECT_THROW(repo->lookupMany(oids, [](const Object &) {}, 2), Exception);
+}
+
+void TestRepository::testBlobStreams()
+{
+    initTestRepo();
+    repo->open(testdir);
+
+    QByteArray content;
+    for (int i = 0; i < 10000; ++i) {
+        content += QByteArray::number(i) + '\n';
+    }
+
+    BlobWriter writer(*repo);
+    QVERIFY(writer.open());
+    for (int pos = 0; pos < content.size(); pos += 4096) {
+        QCOMPARE(writer.write(content.mid(pos, 4096)), qint64(content.mid(pos, 4096).size()));
+    }
+    OId oid = writer.commit();
+    QVERIFY(!writer.isOpen());
+    QCOMPARE(oid, repo->createBlobFromBuffer(content));
+
+    BlobReader reader(*repo, oid);
+    QVERIFY(reader.open());
+    QCOMPARE(reader.size(), qint64(content.size()));
+    QByteArray read;
+    while (!reader.atEnd()) {
+        QByteArray chunk = reader.read(1000);
+        QVERIFY(!chunk.isEmpty());
+        read += chunk;
+    }
+    QCOMPARE(read, content);
+
+    // the new blob is loose, so it is streamed whatever the limit
+    BlobReader limited(*repo, oid);
+    limited.setMaxInflatedSize(1);
+    QVERIFY(limited.open());
+    QVERIFY(limited.isSequential());
+    QCOMPARE(limited.readAll(), content);
+
+    BlobReader missing(*repo, OId::stringToOid("0123456789012345678901234567890123456789"));
+    QVERIFY(!missing.open());
+    QVERIFY(!missing.errorString().isEmpty());
+}
+
+void TestRepository::testBlobContentView()
+{
+    initTestRepo();
+    repo->open(testdir);
+
+    const QByteArray content("content seen through a view\n");
+    const OId oid = repo->createBlobFromBuffer(content);
+
+    BlobContentView view;
+    {
+        Blob blob = repo->lookupBlob(oid);
+        view = blob.contentView();
+        QCOMPARE(view.data(), static_cast<const char*>(blob.rawContent()));
+    }
+
+    // the view keeps the blob alive
+    QCOMPARE(view.size(), qint64(content.size()));
+    QCOMPARE(view.toByteArray(), content);
+    QCOMPARE(view.blob().oid(), oid);
+    QVERIFY(Blob().contentView().isEmpty());
+}
+
 QTEST_MAIN(TestRepository)
 
 #include "Repository.moc"
@@ -4,6 +4,7 @@
 #include "TestHelpers.h"
 
 #include <QCoreApplication>
+#include <QDateTime>
 #include <QPointer>
 #include <QTimer>
 #include <iostream>
@@ -11,8 +12,14 @@
 #include <bitset>
 
 #include "qgitcommit.h"
+#include "qgitcommitbatch.h"
+#include "qgitcommitgraph.h"
+#include "qgitindex.h"
+#include "qgitparallelrevwalk.h"
 #include "qgitrepository.h"
 #include "qgitrevwalk.h"
+#include "qgitsignature.h"
+#include "qgittree.h"
 
 
 using namespace LibQGit2;
@@ -27,8 +34,16 @@ private slots:
     void cleanup();
 
     void revwalk();
+    void revwalkBatch();
+    void parallelRevwalk();
+    void commitGraph();
+    void commitGraphMerges();
+    void commitGraphUpdate();
 
 private:
+    static OId commit(Repository &repository, const QList<OId> &parents, const QString &ref);
+    static void compareAheadBehind(Repository &repository, const CommitGraph &graph, const OId &local, const OId &upstream);
+
     QPointer<Repository> repo;
 };
 
@@ -81,6 +96,242 @@ void TestRevision::revwalk()
     }
 }
 
+void TestRevision::revwalkBatch()
+{
+    try {
+        RevWalk rw(*repo);
+        rw.setSorting(RevWalk::Topological);
+        rw.pushHead();
+
+        QList<OId> expected;
+        Commit commit;
+        while (rw.next(commit)) {
+            expected << commit.oid();
+        }
+
+        rw.reset();
+        rw.setSorting(RevWalk::Topological);
+        rw.pushHead();
+
+        QList<OId> actual;
+        CommitBatch batch;
+        while (rw.nextBatch(batch, 16)) {
+            QVERIFY(batch.count() <= 16);
+            for (int i = 0; i < batch.count(); ++i) {
+                Commit c = repo->lookupCommit(batch.oid(i));
+                QCOMPARE(batch.parentCount(i), int(c.parentCount()));
+                if (batch.parentCount(i) > 0) {
+                    QVERIFY(batch.parentId(i, 0) == c.parentId(0));
+                }
+                QCOMPARE(batch.at(i).time, qint64(c.dateTime().toTime_t()));
+                QCOMPARE(batch.authorName(i), c.author().name());
+                QCOMPARE(batch.committerEmail(i), c.committer().email());
+                actual << batch.oid(i);
+            }
+        }
+
+        QCOMPARE(actual.size(), expected.size());
+        QVERIFY(actual == expected);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestRevision::parallelRevwalk()
+{
+    try {
+        RevWalk rw(*repo);
+        rw.setSorting(RevWalk::Topological);
+        rw.pushHead();
+
+        QList<OId> expected;
+        OId oid;
+        while (rw.next(oid)) {
+            expected << oid;
+        }
+        QVERIFY(expected.size() > 2);
+
+        // split the history at the middle of the walk
+        ParallelRevWalk prw(*repo, 2);
+        prw.setSorting(RevWalk::Topological);
+        prw.push(expected[expected.size() / 2]);
+        prw.pushHead();
+
+        QVector<OId> actual = prw.walk();
+        QCOMPARE(actual.size(), expected.size());
+        for (int i = 0; i < actual.size(); ++i) {
+            QVERIFY(expected.contains(actual[i]));
+            Commit commit = repo->lookupCommit(actual[i]);
+            for (unsigned p = 0; p < commit.parentCount(); ++p) {
+                // parents always come after their children
+                QVERIFY(actual.indexOf(commit.parentId(p)) > i);
+            }
+        }
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestRevision::commitGraph()
+{
+    try {
+        CommitGraph graph(*repo);
+        graph.update();
+        QVERIFY(graph.count() > 2);
+
+        Commit head = repo->lookupCommit(repo->head().target());
+        QVERIFY(graph.contains(head.oid()));
+        QVERIFY(graph.generation(head.oid()) > 1);
+
+        CommitGraph loaded(*repo);
+        QVERIFY(loaded.load());
+        QCOMPARE(loaded.count(), graph.count());
+
+        Commit parent = head.parent(0);
+        Commit grandParent = parent.parent(0);
+        QVERIFY(loaded.isAncestor(grandParent.oid(), head.oid()));
+        QVERIFY(loaded.isAncestor(head.oid(), head.oid()));
+        QVERIFY(!loaded.isAncestor(head.oid(), grandParent.oid()));
+        QCOMPARE(loaded.generation(parent.oid()), loaded.generation(head.oid()) - 1);
+
+        QCOMPARE(loaded.mergeBase(head.oid(), grandParent.oid()), grandParent.oid());
+        QCOMPARE(loaded.mergeBase(head.oid(), grandParent.oid()),
+                 repo->mergeBase(head, grandParent).oid());
+
+        Repository::GraphRelationship expected = repo->commitRelationship(head, grandParent);
+        Repository::GraphRelationship actual = loaded.aheadBehind(head.oid(), grandParent.oid());
+        QCOMPARE(actual.ahead, expected.ahead);
+        QCOMPARE(actual.behind, expected.behind);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+OId TestRevision::commit(Repository &repository, const QList<OId> &parents, const QString &ref)
+{
+    static int counter = 0;
+    ++counter;
+
+    QList<Commit> parentCommits;
+    foreach (const OId &parent, parents) {
+        parentCommits << repository.lookupCommit(parent);
+    }
+    Tree tree = repository.lookupTree(repository.index().createTree());
+    Signature signature("Tester", "tester@example.com",
+                        QDateTime::fromTime_t(1400000000 + uint(counter) * 60));
+    return repository.createCommit(tree, parentCommits, signature, signature,
+                                   QString("commit %1").arg(counter), ref);
+}
+
+void TestRevision::compareAheadBehind(Repository &repository, const CommitGraph &graph, const OId &local, const OId &upstream)
+{
+    Repository::GraphRelationship expected = repository.commitRelationship(repository.lookupCommit(local),
+                                                                           repository.lookupCommit(upstream));
+    Repository::GraphRelationship actual = graph.aheadBehind(local, upstream);
+    QCOMPARE(actual.ahead, expected.ahead);
+    QCOMPARE(actual.behind, expected.behind);
+}
+
+void TestRevision::commitGraphMerges()
+{
+    try {
+        Repository repository;
+        repository.init(testdir + "/graph_merges");
+
+        // two branches from r merged into each other twice (m and b2), two
+        // criss-cross merges of those (x and y), and a disjoint history (s1, s2)
+        OId r = commit(repository, QList<OId>(), "refs/heads/a");
+        OId a1 = commit(repository, QList<OId>() << r, "refs/heads/a");
+        OId b1 = commit(repository, QList<OId>() << r, "refs/heads/b");
+        OId a2 = commit(repository, QList<OId>() << a1, "refs/heads/a");
+        OId b2 = commit(repository, QList<OId>() << b1 << a2, "refs/heads/b");
+        OId m = commit(repository, QList<OId>() << a2 << b1, "refs/heads/a");
+        OId x = commit(repository, QList<OId>() << m << b2, "refs/heads/x");
+        OId y = commit(repository, QList<OId>() << b2 << m, "refs/heads/y");
+        OId s1 = commit(repository, QList<OId>(), "refs/heads/s");
+        OId s2 = commit(repository, QList<OId>() << s1, "refs/heads/s");
+
+        CommitGraph graph(repository);
+        graph.update();
+        QCOMPARE(graph.count(), 10);
+
+        // merges
+        QCOMPARE(graph.mergeBase(m, b1), b1);
+        QCOMPARE(graph.mergeBase(a1, b1), r);
+        QCOMPARE(graph.mergeBase(x, a1), a1);
+        QCOMPARE(graph.mergeBase(x, b1),
+                 repository.mergeBase(repository.lookupCommit(x), repository.lookupCommit(b1)).oid());
+        QVERIFY(graph.isAncestor(b1, x));
+        QVERIFY(!graph.isAncestor(m, b2));
+        compareAheadBehind(repository, graph, m, b1);
+        compareAheadBehind(repository, graph, m, b2);
+        compareAheadBehind(repository, graph, x, a1);
+
+        // criss-cross: a2 and b1 are both best merge bases of m and b2, and
+        // m and b2 are both best merge bases of x and y
+        OId base = graph.mergeBase(m, b2);
+        QVERIFY(base == a2 || base == b1);
+        base = graph.mergeBase(x, y);
+        QVERIFY(base == m || base == b2);
+        compareAheadBehind(repository, graph, x, y);
+        compareAheadBehind(repository, graph, y, x);
+
+        // disjoint histories
+        EXPECT_THROW(graph.mergeBase(x, s2), Exception);
+        EXPECT_THROW(repository.mergeBase(repository.lookupCommit(x), repository.lookupCommit(s2)), Exception);
+        QVERIFY(!graph.isAncestor(s1, x));
+        compareAheadBehind(repository, graph, x, s2);
+        compareAheadBehind(repository, graph, s1, y);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestRevision::commitGraphUpdate()
+{
+    try {
+        Repository repository;
+        repository.init(testdir + "/graph_update");
+
+        OId r = commit(repository, QList<OId>(), "refs/heads/master");
+        OId a = commit(repository, QList<OId>() << r, "refs/heads/master");
+        OId b = commit(repository, QList<OId>() << r, "refs/heads/topic");
+
+        CommitGraph graph(repository);
+        graph.update();
+        QCOMPARE(graph.count(), 3);
+
+        // new commits on top of the graph and on a new branch
+        OId m = commit(repository, QList<OId>() << a << b, "refs/heads/master");
+        OId c = commit(repository, QList<OId>() << m, "refs/heads/master");
+        OId s = commit(repository, QList<OId>(), "refs/heads/other");
+        QVERIFY(!graph.contains(c));
+
+        graph.update();
+        QCOMPARE(graph.count(), 6);
+        QVERIFY(graph.contains(m));
+        QVERIFY(graph.contains(c));
+        QVERIFY(graph.contains(s));
+        QCOMPARE(graph.generation(m), graph.generation(a) + 1);
+        QCOMPARE(graph.generation(c), graph.generation(m) + 1);
+        QCOMPARE(graph.generation(s), 1u);
+
+        // updating again without new commits keeps the graph as it is
+        graph.update();
+        QCOMPARE(graph.count(), 6);
+
+        CommitGraph loaded(repository);
+        QVERIFY(loaded.load());
+        QCOMPARE(loaded.count(), 6);
+        QCOMPARE(loaded.generation(c), graph.generation(c));
+        QVERIFY(loaded.isAncestor(b, c));
+        QCOMPARE(loaded.mergeBase(c, b), b);
+        compareAheadBehind(repository, loaded, c, b);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
 QTEST_MAIN(TestRevision);
 
 #include "Revision.moc"
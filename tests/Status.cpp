@@ -0,0 +1,231 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TestHelpers.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+
+#include "qgitcommit.h"
+#include "qgitindex.h"
+#include "qgitdiffdelta.h"
+#include "qgitdifffile.h"
+#include "qgitrepository.h"
+#include "qgitsignature.h"
+#include "qgitstatuslist.h"
+#include "qgitstatusoptions.h"
+#include "qgitstatussnapshot.h"
+#include "qgitstatuswatcher.h"
+#include "qgittree.h"
+
+
+using namespace LibQGit2;
+
+
+class TestStatus : public TestBase
+{
+    Q_OBJECT
+
+private slots:
+    void watcher();
+    void parallelStatus();
+    void snapshot();
+};
+
+
+namespace {
+bool appendTo(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::Append)) {
+        return false;
+    }
+    return file.write(data) == data.size();
+}
+}
+
+
+void TestStatus::watcher()
+{
+    initTestRepo();
+
+    try {
+        Repository repo;
+        repo.open(testdir);
+
+        StatusWatcher watcher(repo);
+        watcher.setDebounceInterval(10);
+        QSignalSpy changes(&watcher, SIGNAL(statusChanged(QString)));
+        QSignalSpy rescans(&watcher, SIGNAL(rescanned()));
+
+        watcher.start();
+        QVERIFY(watcher.isActive());
+        QVERIFY(watcher.changedPaths().isEmpty());
+        QCOMPARE(rescans.count(), 1);
+        QCOMPARE(changes.count(), 0);
+
+        QVERIFY(appendTo(testdir + "/CMakeLists.txt", "# modified\n"));
+        QTRY_VERIFY(watcher.status("CMakeLists.txt").isModifiedInWorkdir());
+        QVERIFY(changes.contains(QVariantList() << QString("CMakeLists.txt")));
+
+        QVERIFY(QDir(testdir).mkpath("newdir/sub"));
+        QVERIFY(appendTo(testdir + "/newdir/sub/new.txt", "new\n"));
+        QTRY_VERIFY(watcher.status("newdir/sub/new.txt").isNewInWorkdir());
+
+        QVERIFY(QFile::remove(testdir + "/README.md"));
+        QTRY_VERIFY(watcher.status("README.md").isDeletedInWorkdir());
+
+        QVERIFY(QDir(testdir + "/newdir").removeRecursively());
+        QTRY_VERIFY(watcher.status("newdir/sub/new.txt").isCurrent());
+
+        // staging changes the index, which triggers a full scan
+        Index index = repo.index();
+        index.addByPath("CMakeLists.txt");
+        index.write();
+        QTRY_VERIFY(watcher.status("CMakeLists.txt").isModifiedInIndex());
+        QVERIFY(rescans.count() > 1);
+
+        QCOMPARE(watcher.changedPaths().size(), 2);
+
+        // committing only moves the branch HEAD points to, which triggers a full scan
+        Signature signature("Tester", "tester@example.com");
+        repo.createCommit(repo.lookupTree(index.createTree()),
+                          QList<Commit>() << repo.lookupCommit(repo.head().target()),
+                          signature, signature, "commit the change", "HEAD");
+        QTRY_VERIFY(watcher.status("CMakeLists.txt").isCurrent());
+        QCOMPARE(watcher.changedPaths(), QStringList() << QString("README.md"));
+
+        // a renamed directory is watched under its new name, and the old name is free
+        QVERIFY(QDir(testdir).mkpath("olddir/sub"));
+        QVERIFY(appendTo(testdir + "/olddir/sub/a.txt", "a\n"));
+        QTRY_VERIFY(watcher.status("olddir/sub/a.txt").isNewInWorkdir());
+        QVERIFY(QDir(testdir).rename("olddir", "newdir"));
+        QTRY_VERIFY(watcher.status("newdir/sub/a.txt").isNewInWorkdir());
+        QVERIFY(watcher.status("olddir/sub/a.txt").isCurrent());
+        QVERIFY(appendTo(testdir + "/newdir/sub/b.txt", "b\n"));
+        QTRY_VERIFY(watcher.status("newdir/sub/b.txt").isNewInWorkdir());
+        QVERIFY(QDir(testdir).mkpath("olddir"));
+        QVERIFY(appendTo(testdir + "/olddir/c.txt", "c\n"));
+        QTRY_VERIFY(watcher.status("olddir/c.txt").isNewInWorkdir());
+        QVERIFY(QDir(testdir + "/newdir").removeRecursively());
+        QVERIFY(QDir(testdir + "/olddir").removeRecursively());
+        QTRY_COMPARE(watcher.changedPaths().size(), 1);
+
+        watcher.stop();
+        QVERIFY(!watcher.isActive());
+        QVERIFY(watcher.status("README.md").isDeletedInWorkdir());
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestStatus::parallelStatus()
+{
+    initTestRepo();
+
+    try {
+        Repository repo;
+        repo.open(testdir);
+
+        // files touched after the index was written, one of them really modified
+        sleep::ms(1100);
+        QStringList touched;
+        touched << "README.md" << "CHANGELOG.md" << "src/qgitoid.h";
+        foreach (const QString &path, touched) {
+            QFile file(testdir + "/" + path);
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            const QByteArray content = file.readAll();
+            QVERIFY(file.seek(0));
+            QCOMPARE(file.write(content), qint64(content.size()));
+        }
+        QVERIFY(appendTo(testdir + "/CMakeLists.txt", "# modified\n"));
+
+        StatusOptions opts(StatusOptions::ShowIndexAndWorkdir, StatusOptions::IncludeUntracked);
+        opts.setThreadCount(4);
+        QCOMPARE(opts.threadCount(), 4);
+        QCOMPARE(StatusOptions(opts).threadCount(), 4);
+
+        StatusList parallel = repo.status(opts);
+        QCOMPARE(parallel.entryCount(), size_t(1));
+        QCOMPARE(parallel.entryByIndex(0).indexToWorkdir().newFile().path(), QString("CMakeLists.txt"));
+        QVERIFY(parallel.entryByIndex(0).status().isModifiedInWorkdir());
+
+        opts.setThreadCount(1);
+        StatusList serial = repo.status(opts);
+        QCOMPARE(serial.entryCount(), parallel.entryCount());
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+void TestStatus::snapshot()
+{
+    initTestRepo();
+
+    try {
+        Repository repo;
+        repo.open(testdir);
+
+        QVERIFY(appendTo(testdir + "/CMakeLists.txt", "# modified\n"));
+        QVERIFY(appendTo(testdir + "/untracked.txt", "new\n"));
+        QVERIFY(QFile::remove(testdir + "/README.md"));
+        QVERIFY(appendTo(testdir + "/CHANGELOG.md", "staged\n"));
+        Index index = repo.index();
+        index.addByPath("CHANGELOG.md");
+        index.write();
+
+        StatusList list = repo.status(StatusOptions(StatusOptions::ShowIndexAndWorkdir, StatusOptions::IncludeUntracked));
+        StatusSnapshot snapshot(list);
+        QCOMPARE(size_t(snapshot.count()), list.entryCount());
+        QCOMPARE(snapshot.count(), 4);
+
+        for (int i = 0; i < snapshot.count(); ++i) {
+            const unsigned int flags = snapshot.rawStatus(i);
+            const QString path = snapshot.path(i).toString();
+            if (path == "CHANGELOG.md") {
+                QCOMPARE(flags, unsigned(GIT_STATUS_INDEX_MODIFIED));
+                QVERIFY(snapshot.headId(i).isValid());
+                QVERIFY(snapshot.indexId(i).isValid());
+                QVERIFY(snapshot.headId(i) != snapshot.indexId(i));
+                QCOMPARE(snapshot.indexId(i), OId(&git_status_byindex(list.data(), size_t(i))->head_to_index->new_file.id));
+            } else if (path == "CMakeLists.txt") {
+                QVERIFY(snapshot.status(i).isModifiedInWorkdir());
+                QVERIFY(!snapshot.headId(i).isValid());
+                QVERIFY(snapshot.indexId(i).isValid());
+            } else if (path == "README.md") {
+                QVERIFY(snapshot.status(i).isDeletedInWorkdir());
+            } else {
+                QCOMPARE(path, QString("untracked.txt"));
+                QVERIFY(snapshot.status(i).isNewInWorkdir());
+                QVERIFY(!snapshot.indexId(i).isValid());
+            }
+            QVERIFY(snapshot.oldPath(i) == snapshot.path(i));
+        }
+
+        StatusSnapshot copy = snapshot;
+        QVERIFY(copy.path(0).data() == snapshot.path(0).data());
+        QVERIFY(StatusSnapshot().isEmpty());
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+QTEST_MAIN(TestStatus)
+
+#include "Status.moc"
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * This file is part of the libqgit2 library
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "TestHelpers.h"
+
+#include <QSignalSpy>
+
+#include "qgitcommit.h"
+#include "qgitref.h"
+#include "qgitrepository.h"
+#include "qgittree.h"
+#include "qgittreeentry.h"
+#include "qgittreemodel.h"
+
+
+using namespace LibQGit2;
+
+
+class TestTree : public TestBase
+{
+    Q_OBJECT
+
+private slots:
+    void model();
+};
+
+
+void TestTree::model()
+{
+    initTestRepo();
+
+    try {
+        Repository repo;
+        repo.open(testdir);
+        Tree head = repo.lookupCommit(repo.head().target()).tree();
+
+        TreeModel model(repo);
+        QCOMPARE(model.rowCount(), 0);
+        QVERIFY(!model.hasChildren());
+
+        model.setTree(head);
+        QCOMPARE(size_t(model.rowCount()), head.entryCount());
+        QCOMPARE(model.loadedTrees(), 1);
+        QCOMPARE(model.cachedTrees(), 1);
+
+        QModelIndex src;
+        QModelIndex readme;
+        for (int i = 0; i < model.rowCount(); ++i) {
+            const QModelIndex index = model.index(i, 0);
+            QVERIFY(!model.parent(index).isValid());
+            if (model.data(index, TreeModel::NameRole).toString() == "src") {
+                src = index;
+            } else if (model.data(index, Qt::DisplayRole).toString() == "README.md") {
+                readme = index;
+            }
+        }
+        QVERIFY(src.isValid());
+        QVERIFY(readme.isValid());
+
+        QCOMPARE(model.data(readme, TreeModel::TypeRole).toInt(), int(Object::BlobType));
+        QCOMPARE(model.id(readme), head.entryByName("README.md").oid());
+        QVERIFY(!model.hasChildren(readme));
+        QVERIFY(!model.canFetchMore(readme));
+
+        // the subtree is only read when asked for
+        QCOMPARE(model.data(src, TreeModel::TypeRole).toInt(), int(Object::TreeType));
+        QVERIFY(model.hasChildren(src));
+        QCOMPARE(model.rowCount(src), 0);
+        QVERIFY(model.canFetchMore(src));
+
+        QSignalSpy inserted(&model, &TreeModel::rowsInserted);
+        model.fetchMore(src);
+        QCOMPARE(inserted.count(), 1);
+        QVERIFY(!model.canFetchMore(src));
+        QCOMPARE(model.loadedTrees(), 2);
+        QCOMPARE(model.cachedTrees(), 2);
+
+        Tree srcTree = repo.lookupTree(model.id(src));
+        QCOMPARE(size_t(model.rowCount(src)), srcTree.entryCount());
+        const QModelIndex child = model.index(0, 0, src);
+        QCOMPARE(model.parent(child), src);
+        QCOMPARE(model.path(child), "src/" + srcTree.entryByIndex(0).name());
+        QCOMPARE(model.data(child, TreeModel::PathRole).toString(), model.path(child));
+        QCOMPARE(model.id(child), srcTree.entryByIndex(0).oid());
+
+        // showing the tree again reuses the cached trees
+        model.setTree(head);
+        QCOMPARE(model.loadedTrees(), 1);
+        QCOMPARE(model.cachedTrees(), 2);
+
+        model.setCacheSize(1);
+        QCOMPARE(model.cacheSize(), 1);
+        QVERIFY(model.cachedTrees() <= 1);
+
+        model.setTree(Tree());
+        QCOMPARE(model.rowCount(), 0);
+    } catch (const Exception& ex) {
+        QFAIL(ex.what());
+    }
+}
+
+QTEST_MAIN(TestTree)
+
+#include "Tree.moc"